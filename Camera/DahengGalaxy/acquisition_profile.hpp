@@ -0,0 +1,76 @@
+#ifndef ACQUISITION_PROFILE_HPP
+#define ACQUISITION_PROFILE_HPP
+
+#include <cstddef>
+
+#include "camera_backend.hpp"
+#include "frame_worker.hpp"
+
+
+/**
+ * @brief 采集配置：SDK 流层缓冲与内部帧池、转换队列的匹配组合
+ *
+ *   Balanced   - 默认，按顺序交付，帧池按 256 MB 预算
+ *   LowLatency - 实时对位：SDK 只交付最新帧，帧池与转换队列最小，转换跟不上时丢弃最旧的帧，总是转换最新帧
+ *   Lossless   - 录制：SDK 深缓冲按顺序交付，帧池按 1 GB 预算，转换与录制队列随之加深
+ */
+enum class AcquisitionProfile {
+    Balanced,
+    LowLatency,
+    Lossless,
+};
+
+static constexpr int kAcquisitionProfileCount = 3;
+
+inline const char *acquisitionProfileName(AcquisitionProfile profile) {
+    switch (profile) {
+        case AcquisitionProfile::Balanced: return "Balanced";
+        case AcquisitionProfile::LowLatency: return "LowLatency";
+        case AcquisitionProfile::Lossless: return "Lossless";
+    }
+
+    return "Unknown";
+}
+
+
+struct AcquisitionProfileSettings {
+    AcquisitionProfile profile = AcquisitionProfile::Balanced;
+    StreamBufferSettings stream;
+    size_t frame_pool_size = 0;                          // 0 表示按内存预算计算
+    size_t frame_pool_budget = 256 * 1024 * 1024;        // 字节
+    size_t frame_pool_max = 32;
+    size_t convert_queue_capacity = 4;                   // 等待格式转换的最大帧数
+    FrameWorker::OverflowPolicy convert_overflow = FrameWorker::OverflowPolicy::DropNewest;  // 转换队列满时的处理
+    size_t recording_queue_capacity = 8;                 // startRecording() 默认的写盘队列容量
+
+    static AcquisitionProfileSettings preset(AcquisitionProfile profile) {
+        AcquisitionProfileSettings settings;
+        settings.profile = profile;
+
+        switch (profile) {
+            case AcquisitionProfile::Balanced:
+                break;
+            case AcquisitionProfile::LowLatency:
+                settings.stream.mode = StreamBufferSettings::Mode::NewestOnly;
+                settings.stream.buffer_count = 3;
+                settings.frame_pool_size = 6;            // 三缓冲 + 正在写入与显示的帧
+                settings.convert_queue_capacity = 1;
+                settings.convert_overflow = FrameWorker::OverflowPolicy::DropOldest;
+                settings.recording_queue_capacity = 2;
+                break;
+            case AcquisitionProfile::Lossless:
+                settings.stream.mode = StreamBufferSettings::Mode::OldestFirst;
+                settings.stream.buffer_count = 64;
+                settings.frame_pool_budget = (size_t) 1024 * 1024 * 1024;
+                settings.frame_pool_max = 128;
+                settings.convert_queue_capacity = 16;
+                settings.recording_queue_capacity = 64;
+                break;
+        }
+
+        return settings;
+    }
+};
+
+
+#endif // ACQUISITION_PROFILE_HPP
@@ -0,0 +1,153 @@
+#ifndef AUTO_EXPOSURE_HPP
+#define AUTO_EXPOSURE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "frame_statistics.hpp"
+
+
+struct AutoExposureSettings {
+    double target_level = 0.45;             // 目标平均亮度，占满量程的比例
+    double tolerance = 0.06;                // 相对目标的允许偏差
+    double max_saturated_fraction = 0.01;   // 允许的饱和像素比例
+    double min_exposure_us = 1000;
+    double max_exposure_us = 1000000;
+    double min_gain_db = 0;
+    double max_gain_db = 24;
+    int settle_frames = 2;                  // 调整后跳过的帧数（调整前已开始曝光的帧）
+    int max_iterations = 20;                // 单次收敛允许的最大调整次数，连续模式下不限制
+    int subsample = 4;                      // 统计直方图时的行列采样间隔
+    cv::Rect roi;                           // 测光区域（帧坐标），空区域表示整帧
+    bool continuous = false;                // 收敛后继续跟踪亮度变化
+};
+
+
+/**
+ * @brief 基于直方图的自动曝光控制算法
+ *
+ * 只负责根据一帧的统计结果（FrameStatistics）计算下一组曝光时间与增益，不访问相机。
+ * 线性传感器下亮度与曝光时间 × 增益成正比，按目标亮度与实测亮度之比一步调整，通常几帧内即可收敛；
+ * 先调整曝光时间，曝光时间到达上限后再提高增益。
+ */
+class AutoExposure {
+public:
+    enum class State {
+        Adjusting,   // 已调整，等待新设置生效
+        Converged,   // 亮度已在目标范围内
+        Limited,     // 已到曝光时间与增益的边界，无法继续调整
+        Failed,      // 超过最大调整次数仍未收敛
+    };
+
+    void reset(const AutoExposureSettings &settings, double exposure_us, double gain_db) {
+        m_settings = settings;
+        m_exposure_us = clamp(exposure_us, m_settings.min_exposure_us, m_settings.max_exposure_us);
+        m_gain_db = clamp(gain_db, m_settings.min_gain_db, m_settings.max_gain_db);
+        m_iterations = 0;
+        m_state = State::Adjusting;
+        m_level = 0;
+    }
+
+    /**
+     * @brief 输入一帧的统计结果，计算新的曝光时间与增益
+     * @return Adjusting 时应把 exposureUs() / gainDb() 写入相机
+     */
+    State update(const FrameStatistics &stats) {
+        if (!stats.valid || stats.pixel_count == 0) return m_state;
+
+        // 由 256 级直方图计算亮度，与像素位深无关
+        const int bins = FrameStatistics::kHistogramBins;
+        uint64_t sum = 0;
+        for (int i = 0; i < bins; i++) {
+            sum += (uint64_t) stats.histogram[i] * (uint64_t) i;
+        }
+        m_level = (double) sum / (double) stats.pixel_count / (bins - 1);
+        double saturated = stats.saturatedFraction();
+
+        double error = std::fabs(m_level - m_settings.target_level) / m_settings.target_level;
+        bool saturated_ok = saturated <= m_settings.max_saturated_fraction;
+
+        // 连续模式下收敛后使用两倍容差，避免在边界附近来回调整
+        double tolerance = m_state == State::Converged ? m_settings.tolerance * 2 : m_settings.tolerance;
+        if (error <= tolerance && saturated_ok) {
+            m_state = State::Converged;
+            m_iterations = 0;
+            return m_state;
+        }
+
+        if (!m_settings.continuous && m_iterations >= m_settings.max_iterations) {
+            m_state = State::Failed;
+            return m_state;
+        }
+        m_iterations++;
+
+        // 全黑时亮度无参考，按最大步长提高
+        double ratio = m_settings.target_level / std::max(m_level, 0.5 / (bins - 1));
+        ratio = clamp(ratio, 1.0 / 8, 8.0);
+        if (!saturated_ok) ratio = std::min(ratio, 0.7);  // 饱和时平均亮度偏低，先保证压暗
+
+        double total_gain = m_exposure_us * dbToLinear(m_gain_db) * ratio;
+        double exposure_us = clamp(total_gain / dbToLinear(m_settings.min_gain_db),
+                                   m_settings.min_exposure_us, m_settings.max_exposure_us);
+        double gain_db = clamp(linearToDb(total_gain / exposure_us), m_settings.min_gain_db, m_settings.max_gain_db);
+
+        if (std::fabs(exposure_us - m_exposure_us) < 1 && std::fabs(gain_db - m_gain_db) < 0.01) {
+            m_state = State::Limited;
+            return m_state;
+        }
+
+        m_exposure_us = exposure_us;
+        m_gain_db = gain_db;
+        m_state = State::Adjusting;
+
+        return m_state;
+    }
+
+    State state() const {
+        return m_state;
+    }
+
+    double exposureUs() const {
+        return m_exposure_us;
+    }
+
+    double gainDb() const {
+        return m_gain_db;
+    }
+
+    /**
+     * @brief 最近一帧的平均亮度，占满量程的比例
+     */
+    double level() const {
+        return m_level;
+    }
+
+    const AutoExposureSettings &settings() const {
+        return m_settings;
+    }
+
+private:
+    static double clamp(double value, double low, double high) {
+        return std::min(std::max(value, low), high);
+    }
+
+    static double dbToLinear(double db) {
+        return std::pow(10.0, db / 20.0);
+    }
+
+    static double linearToDb(double linear) {
+        return 20.0 * std::log10(linear);
+    }
+
+private:
+    AutoExposureSettings m_settings;
+    double m_exposure_us = 10000;
+    double m_gain_db = 0;
+    double m_level = 0;
+    int m_iterations = 0;
+    State m_state = State::Adjusting;
+};
+
+
+#endif // AUTO_EXPOSURE_HPP
@@ -0,0 +1,157 @@
+#ifndef CAMERA_BACKEND_HPP
+#define CAMERA_BACKEND_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "camera_parameters.hpp"
+
+
+/**
+ * @brief 后端交付的原始帧，data 只在回调期间有效
+ */
+struct RawFrame {
+    const void *data = nullptr;
+    size_t size = 0;
+    int width = 0;
+    int height = 0;
+    uint64_t frame_id = 0;
+    uint64_t timestamp = 0;
+};
+
+
+/**
+ * @brief SDK 流层缓冲策略
+ */
+struct StreamBufferSettings {
+    enum class Mode {
+        OldestFirst,            // 按顺序交付，缓冲满时丢弃新帧
+        OldestFirstOverwrite,   // 按顺序交付，缓冲满时覆盖最旧的帧
+        NewestOnly,             // 只交付最新一帧
+    };
+
+    Mode mode = Mode::OldestFirst;
+    uint32_t buffer_count = 0;  // 采集缓冲数，0 表示 SDK 默认
+};
+
+
+/**
+ * @brief 相机后端接口，CameraController 通过它访问具体的相机（或模拟源）
+ *
+ * 特征（feature）使用 GenICam 标准名称，如 "ExposureTime"、"Gain"、"TriggerMode"。
+ * 帧回调运行在后端自己的采集线程中。
+ */
+class ICameraBackend {
+public:
+    using FrameCallback = std::function<void(const RawFrame &)>;
+
+    ICameraBackend() = default;
+
+    virtual ~ICameraBackend() {}
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+    virtual bool start(const FrameCallback &callback) = 0;
+    virtual void stop() = 0;
+
+    virtual bool isOpen() const = 0;
+    virtual bool isGrabbing() const = 0;
+
+    virtual std::string serialNumber() const = 0;
+
+    virtual void enterTriggerMode() = 0;
+    virtual void exitTriggerMode() = 0;
+    virtual void softwareTrigger() = 0;
+
+    virtual int64_t getIntFeature(const std::string &name) = 0;
+    virtual void setIntFeature(const std::string &name, int64_t value) = 0;
+    virtual double getFloatFeature(const std::string &name) = 0;
+    virtual void setFloatFeature(const std::string &name, double value) = 0;
+    virtual std::string getEnumFeature(const std::string &name) = 0;
+    virtual void setEnumFeature(const std::string &name, const std::string &value) = 0;
+    virtual void executeCommand(const std::string &name) = 0;
+
+    /**
+     * @brief 设备是否实现了该特征
+     */
+    virtual bool hasFeature(const std::string &name) {
+        return true;
+    }
+
+    /**
+     * @brief 整型特征的当前取值范围与步进，不支持时返回 false
+     */
+    virtual bool getIntFeatureRange(const std::string &name, int64_t &min, int64_t &max, int64_t &inc) {
+        return false;
+    }
+
+    /**
+     * @brief 丢弃已采集但尚未交付的帧（如切换到触发模式时残留的连续采集帧）
+     */
+    virtual void flushQueue() {}
+
+    /**
+     * @brief 设置流层缓冲策略，在下次 start() 时生效
+     * @return 后端不支持时返回 false
+     */
+    virtual bool setStreamBuffering(const StreamBufferSettings &settings) {
+        return false;
+    }
+
+    /**
+     * @brief 按顺序写入一组参数，单个参数失败不影响其余参数
+     * @param failed - 不为空时返回写入失败的参数名
+     * @return 是否全部写入成功
+     */
+    virtual bool applyParameters(const CameraParameterSet &parameters, std::vector<std::string> *failed = nullptr) {
+        bool ok = true;
+
+        for (const CameraParameterSet::Entry &entry : parameters.entries()) {
+            try {
+                switch (entry.type) {
+                    case CameraParameterSet::Type::Int: setIntFeature(entry.name, entry.int_value); break;
+                    case CameraParameterSet::Type::Float: setFloatFeature(entry.name, entry.float_value); break;
+                    case CameraParameterSet::Type::Enum: setEnumFeature(entry.name, entry.enum_value); break;
+                    case CameraParameterSet::Type::Command: executeCommand(entry.name); break;
+                }
+            } catch (...) {
+                ok = false;
+                if (failed) failed->push_back(entry.name);
+            }
+        }
+
+        return ok;
+    }
+
+    /**
+     * @brief 按 layout 中的参数名与类型读回当前值，未实现或读取失败的参数不出现在结果中
+     */
+    virtual CameraParameterSet readParameters(const CameraParameterSet &layout) {
+        CameraParameterSet result;
+
+        for (const CameraParameterSet::Entry &entry : layout.entries()) {
+            try {
+                if (!hasFeature(entry.name)) continue;
+
+                switch (entry.type) {
+                    case CameraParameterSet::Type::Int: result.setInt(entry.name, getIntFeature(entry.name)); break;
+                    case CameraParameterSet::Type::Float: result.setFloat(entry.name, getFloatFeature(entry.name)); break;
+                    case CameraParameterSet::Type::Enum: result.setEnum(entry.name, getEnumFeature(entry.name)); break;
+                    case CameraParameterSet::Type::Command: break;
+                }
+            } catch (...) {}
+        }
+
+        return result;
+    }
+
+private:
+    ICameraBackend(const ICameraBackend &) = delete;
+    ICameraBackend &operator=(const ICameraBackend &) = delete;
+};
+
+
+#endif // CAMERA_BACKEND_HPP
@@ -0,0 +1,31 @@
+/**
+ * @brief 采集链路基准测试程序，测试本身见 camera_benchmark.hpp 中的 CameraBenchmark
+ *
+ * 编译：定义 NO_GALAXY_CAMERA（本文件已定义），链接 Qt Core / Gui 与 OpenCV，camera_controller.hpp 需经 moc 处理。
+ *
+ * 用法：
+ *   camera_benchmark [--resolutions 640x480,1920x1080] [--fps 30,0] [--consumers 0,1,4]
+ *                    [--format Mono8] [--profile Balanced|LowLatency|Lossless]
+ *                    [--duration 3] [--warmup 0.5] [--hold-ms 2] [--csv]
+ */
+
+#define NO_GALAXY_CAMERA
+
+#include <QCoreApplication>
+
+#include <iostream>
+
+#include "camera_benchmark.hpp"
+
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    CameraBenchmark::Options options;
+    if (!CameraBenchmark::parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: camera_benchmark " << CameraBenchmark::usage() << std::endl;
+        return 1;
+    }
+
+    return CameraBenchmark::run(options);
+}
@@ -0,0 +1,333 @@
+#ifndef CAMERA_BENCHMARK_HPP
+#define CAMERA_BENCHMARK_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "simulated_camera_backend.hpp"
+#include "camera_controller.hpp"
+
+
+/**
+ * @brief 采集链路基准测试：用合成图像后端驱动 CameraController 的采集回调路径，无需相机与界面
+ *
+ * 按分辨率 × 帧率 × 消费者数扫描，每组输出一行 JSON（或 CSV），包括实际帧率、拷贝带宽、
+ * 回调延迟百分位与丢帧率，可保存为基线并与修改后的结果逐行比较。进度信息输出到 stderr。
+ *
+ * 独立程序见 camera_benchmark.cpp；其它程序也可以在创建 QCoreApplication 之后直接调用 run()。
+ *
+ * 参数：[--resolutions 640x480,1920x1080] [--fps 30,0] [--consumers 0,1,4]
+ *       [--format Mono8] [--profile Balanced|LowLatency|Lossless]
+ *       [--duration 3] [--warmup 0.5] [--hold-ms 2] [--csv]
+ *
+ *   fps 为 0 表示不限速，测量链路的最大吞吐量；hold-ms 为每个消费者持有一帧的时间。
+ */
+class CameraBenchmark {
+public:
+    struct Options {
+        std::vector<std::pair<int, int>> resolutions = {{640, 480}, {1920, 1080}, {4096, 3000}};
+        std::vector<double> fps = {30, 0};
+        std::vector<int> consumers = {0, 1, 4};
+        PixelFormat format = PixelFormat::Mono8;
+        AcquisitionProfile profile = AcquisitionProfile::Balanced;
+        double duration_sec = 3;
+        double warmup_sec = 0.5;
+        double hold_ms = 2;
+        bool csv = false;
+    };
+
+    struct Result {
+        int width = 0;
+        int height = 0;
+        double target_fps = 0;
+        int consumers = 0;
+        double elapsed_sec = 0;
+        FrameMetrics::Snapshot delta;     // 计数器为测量区间内的增量，直方图只包含测量区间
+        size_t frame_bytes = 0;
+        size_t raw_bytes = 0;
+        size_t pool_size = 0;
+    };
+
+    /**
+     * @brief 解析命令行参数（argv[0] 为程序名），参数有误时输出错误到 stderr
+     */
+    static bool parseOptions(int argc, char *argv[], Options &options) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            std::string value = i + 1 < argc ? argv[i + 1] : "";
+
+            if (arg == "--csv") {
+                options.csv = true;
+                continue;
+            }
+            if (value.empty()) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                return false;
+            }
+            i++;
+
+            if (arg == "--resolutions") {
+                options.resolutions.clear();
+                for (const std::string &item : splitList(value)) {
+                    int width = 0, height = 0;
+                    char x = 0;
+                    std::stringstream ss(item);
+                    if (!(ss >> width >> x >> height) || x != 'x' || width <= 0 || height <= 0) {
+                        std::cerr << "Bad resolution: " << item << std::endl;
+                        return false;
+                    }
+                    options.resolutions.emplace_back(width, height);
+                }
+            } else if (arg == "--fps") {
+                options.fps.clear();
+                for (const std::string &item : splitList(value)) {
+                    options.fps.push_back(std::atof(item.c_str()));
+                }
+            } else if (arg == "--consumers") {
+                options.consumers.clear();
+                for (const std::string &item : splitList(value)) {
+                    options.consumers.push_back(std::max(0, std::atoi(item.c_str())));
+                }
+            } else if (arg == "--format") {
+                options.format = pixelFormatFromName(value);
+                if (options.format == PixelFormat::Unknown) {
+                    std::cerr << "Unknown pixel format: " << value << std::endl;
+                    return false;
+                }
+            } else if (arg == "--profile") {
+                if (value == "Balanced") {
+                    options.profile = AcquisitionProfile::Balanced;
+                } else if (value == "LowLatency") {
+                    options.profile = AcquisitionProfile::LowLatency;
+                } else if (value == "Lossless") {
+                    options.profile = AcquisitionProfile::Lossless;
+                } else {
+                    std::cerr << "Unknown profile: " << value << std::endl;
+                    return false;
+                }
+            } else if (arg == "--duration") {
+                options.duration_sec = std::atof(value.c_str());
+            } else if (arg == "--warmup") {
+                options.warmup_sec = std::atof(value.c_str());
+            } else if (arg == "--hold-ms") {
+                options.hold_ms = std::atof(value.c_str());
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            }
+        }
+
+        return !options.resolutions.empty() && !options.fps.empty() && !options.consumers.empty() &&
+               options.duration_sec > 0;
+    }
+
+    /**
+     * @brief 依次运行全部组合，结果逐行写入 out
+     * @return 0 表示全部完成，合成相机打开失败时返回 2
+     */
+    static int run(const Options &options, std::ostream &out = std::cout) {
+        if (options.csv) out << csvHeader() << std::endl;
+
+        for (const auto &resolution : options.resolutions) {
+            for (double fps : options.fps) {
+                for (int consumers : options.consumers) {
+                    std::cerr << "Running " << resolution.first << "x" << resolution.second << " fps " << fps
+                              << " consumers " << consumers << " ..." << std::endl;
+
+                    Result result = runCase(options, resolution.first, resolution.second, fps, consumers);
+                    if (result.elapsed_sec <= 0) return 2;
+
+                    out << formatResult(options, result) << std::endl;
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    /**
+     * @brief 参数说明，不含程序名
+     */
+    static const char *usage() {
+        return "[--resolutions WxH,...] [--fps F,...] [--consumers N,...] "
+               "[--format Mono8] [--profile Balanced|LowLatency|Lossless] [--duration S] [--warmup S] "
+               "[--hold-ms MS] [--csv]";
+    }
+
+    /**
+     * @brief 运行单个组合：预热后测量 duration_sec，合成相机打开失败时 elapsed_sec 为 0
+     */
+    static Result runCase(const Options &options, int width, int height, double fps, int consumers) {
+        using clock = std::chrono::steady_clock;
+
+        Result result;
+        result.width = width;
+        result.height = height;
+        result.target_fps = fps;
+        result.consumers = consumers;
+
+        CameraController camera(std::unique_ptr<ICameraBackend>(new SyntheticCameraBackend(width, height, fps)));
+        camera.setPixelFormat(options.format);
+        camera.setAcquisitionProfile(options.profile);
+        camera.openCamera();
+        if (!camera.isCameraOpen()) {
+            std::cerr << "Open synthetic camera failed: " << width << "x" << height << std::endl;
+            return result;
+        }
+
+        result.frame_bytes = (size_t) camera.getBufferSize();
+        result.raw_bytes = pixelFormatRawSize(camera.getPixelFormat(), width, height);
+        result.pool_size = camera.getFramePoolSize();
+
+        std::atomic<bool> running(true);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < consumers; i++) {
+            threads.emplace_back(consumerLoop, &camera, &running, options.hold_ms);
+        }
+
+        // 预热后清空直方图，计数器按差值计算
+        std::this_thread::sleep_for(std::chrono::duration<double>(options.warmup_sec));
+        FrameMetrics::Snapshot before = camera.getFrameMetrics().snapshot(true);
+        auto begin = clock::now();
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(options.duration_sec));
+
+        FrameMetrics::Snapshot after = camera.getFrameMetrics().snapshot(true);
+        result.elapsed_sec = std::chrono::duration<double>(clock::now() - begin).count();
+
+        running = false;
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        camera.closeCamera();
+
+        result.delta = after;
+        result.delta.frames_received -= before.frames_received;
+        result.delta.frames_published -= before.frames_published;
+        result.delta.frames_picked_up -= before.frames_picked_up;
+        result.delta.frames_painted -= before.frames_painted;
+        result.delta.sdk_dropped -= before.sdk_dropped;
+        result.delta.pool_dropped -= before.pool_dropped;
+        result.delta.convert_dropped -= before.convert_dropped;
+        result.delta.skipped -= before.skipped;
+
+        return result;
+    }
+
+    static const char *csvHeader() {
+        return "width,height,format,profile,target_fps,consumers,pool_size,elapsed_s,"
+               "received,published,achieved_fps,copy_mb_per_s,"
+               "drop_sdk,drop_pool,drop_convert,drop_rate,skipped,"
+               "callback_p50_us,callback_p90_us,callback_p99_us,callback_max_us,"
+               "convert_p50_us,convert_p99_us,pickup_p50_us,pickup_p99_us";
+    }
+
+    /**
+     * @brief 一组结果格式化为一行 JSON 或 CSV（与 csvHeader() 对应）
+     */
+    static std::string formatResult(const Options &options, const Result &r) {
+        const FrameMetrics::Snapshot &s = r.delta;
+        double elapsed = r.elapsed_sec > 0 ? r.elapsed_sec : 1;
+        double achieved_fps = s.frames_published / elapsed;
+
+        // 拷贝量：采集回调拷贝原始帧；需要格式转换时另有一次写入输出帧
+        bool converted = !pixelFormatIsPassThrough(options.format);
+        double bytes = (double) s.frames_published * (double) r.frame_bytes;
+        if (converted) bytes += (double) (s.frames_received - s.pool_dropped) * (double) r.raw_bytes;
+        double copy_mb_per_s = bytes / elapsed / (1024.0 * 1024.0);
+
+        uint64_t dropped = s.sdk_dropped + s.pool_dropped + s.convert_dropped;
+        uint64_t offered = s.frames_received + s.sdk_dropped;
+        double drop_rate = offered > 0 ? (double) dropped / (double) offered : 0;
+
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(2);
+
+        if (options.csv) {
+            ss << r.width << "," << r.height << "," << pixelFormatName(options.format) << ","
+               << acquisitionProfileName(options.profile) << "," << r.target_fps << "," << r.consumers << ","
+               << r.pool_size << "," << r.elapsed_sec << ","
+               << s.frames_received << "," << s.frames_published << "," << achieved_fps << "," << copy_mb_per_s << ","
+               << s.sdk_dropped << "," << s.pool_dropped << "," << s.convert_dropped << ","
+               << std::setprecision(6) << drop_rate << std::setprecision(2) << "," << s.skipped << ","
+               << s.copy.p50_us << "," << s.copy.p90_us << "," << s.copy.p99_us << "," << s.copy.max_us << ","
+               << s.convert.p50_us << "," << s.convert.p99_us << "," << s.pickup.p50_us << "," << s.pickup.p99_us;
+            return ss.str();
+        }
+
+        ss << "{\"width\":" << r.width << ",\"height\":" << r.height
+           << ",\"format\":\"" << pixelFormatName(options.format) << "\""
+           << ",\"profile\":\"" << acquisitionProfileName(options.profile) << "\""
+           << ",\"target_fps\":" << r.target_fps << ",\"consumers\":" << r.consumers
+           << ",\"pool_size\":" << r.pool_size << ",\"elapsed_s\":" << r.elapsed_sec
+           << ",\"received\":" << s.frames_received << ",\"published\":" << s.frames_published
+           << ",\"achieved_fps\":" << achieved_fps << ",\"copy_mb_per_s\":" << copy_mb_per_s
+           << ",\"drop\":{\"sdk\":" << s.sdk_dropped << ",\"pool\":" << s.pool_dropped
+           << ",\"convert\":" << s.convert_dropped << ",\"rate\":" << std::setprecision(6) << drop_rate
+           << std::setprecision(2) << "},\"skipped\":" << s.skipped;
+
+        auto latency = [&ss](const char *name, const LatencyHistogram::Summary &h) {
+            ss << ",\"" << name << "_us\":{\"count\":" << h.count << ",\"mean\":" << h.mean_us
+               << ",\"p50\":" << h.p50_us << ",\"p90\":" << h.p90_us << ",\"p99\":" << h.p99_us
+               << ",\"max\":" << h.max_us << "}";
+        };
+        latency("callback", s.copy);
+        latency("convert", s.convert);
+        latency("pickup", s.pickup);
+        latency("end_to_end", s.end_to_end);
+        ss << "}";
+
+        return ss.str();
+    }
+
+private:
+    static std::vector<std::string> splitList(const std::string &text) {
+        std::vector<std::string> items;
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            if (!item.empty()) items.push_back(item);
+        }
+        return items;
+    }
+
+    /**
+     * @brief 模拟显示或处理线程：轮询最新帧，读取整帧（每页一个字节）并持有 hold_ms 后释放
+     */
+    static void consumerLoop(CameraController *camera, const std::atomic<bool> *running, double hold_ms) {
+        uint64_t last_sequence = 0;
+        volatile uint8_t sink = 0;
+
+        while (*running) {
+            FrameRef frame = camera->getFrame();
+            if (!frame || frame->sequence == last_sequence) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                continue;
+            }
+            last_sequence = frame->sequence;
+
+            const std::vector<uint8_t> &data = frame->data;
+            for (size_t i = 0; i < data.size(); i += 4096) {
+                sink = sink + data[i];
+            }
+            camera->recordFramePaint(frame);
+
+            if (hold_ms > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds((int64_t) (hold_ms * 1000)));
+            }
+        }
+    }
+};
+
+
+#endif // CAMERA_BENCHMARK_HPP
@@ -3,90 +3,427 @@
 
 #include <QObject>
 #include <QImage>
+#include <QMetaMethod>
 #include <QTimer>
 
 #include <iostream>
 #include <exception>
+#include <memory>
 #include <mutex>
+#include <atomic>
+#include <cstring>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <chrono>
+#include <future>
 
-#include "GalaxyIncludes.h"
 #include "opencv2/opencv.hpp"
+#include "acquisition_profile.hpp"
+#include "auto_exposure.hpp"
+#include "camera_backend.hpp"
+#include "camera_parameters.hpp"
+#include "flat_field.hpp"
+#include "frame_metrics.hpp"
+#include "focus_metric.hpp"
+#include "frame_accumulator.hpp"
+#include "frame_converter.hpp"
+#include "frame_pipeline.hpp"
+#include "frame_pool.hpp"
+#include "frame_recorder.hpp"
+#include "frame_statistics.hpp"
+#include "frame_worker.hpp"
+#include "image_exporter.hpp"
+#include "pixel_format.hpp"
+#include "shared_frame_ring.hpp"
+#include "triple_buffer.hpp"
+#include "trigger_matcher.hpp"
+
+// 无相机 / 无 Galaxy SDK 环境下使用合成图像后端
+// #define NO_GALAXY_CAMERA
+
+#ifdef NO_GALAXY_CAMERA
+#include "simulated_camera_backend.hpp"
+#else
+#include "galaxy_camera_backend.hpp"
+#endif
+
+
+/**
+ * @brief 图像几何设置：ROI 以合并、抽点之后的像素为单位
+ */
+struct ImageGeometry {
+    int offset_x = 0;
+    int offset_y = 0;
+    int width = 0;                  // 0 表示到传感器边缘
+    int height = 0;
+    int binning_horizontal = 1;
+    int binning_vertical = 1;
+    int decimation_horizontal = 1;
+    int decimation_vertical = 1;
+};
 
 
 class CameraController : public QObject {
     Q_OBJECT
 
-private:
-    CameraController()
-            : m_pCaptureEventHandler(nullptr),
+public:
+    /**
+     * @param backend - 相机后端，为空时使用默认后端（打开第一台 Galaxy 设备）
+     */
+    explicit CameraController(std::unique_ptr<ICameraBackend> backend = nullptr, QObject *parent = nullptr)
+            : QObject(parent),
+              m_backend(std::move(backend)),
               m_bIsOpen(false),
               m_bIsSnap(false),
+              m_bIsTriggerMode(false),
+              m_has_image(false),
               m_image_height(0),
               m_image_width(0),
-              m_buffer_size(0) {
-        cameraInit();
+              m_buffer_size(0),
+              m_image_step(0),
+              m_image_cv_type(CV_8UC1),
+              m_image_qformat(QImage::Format_Grayscale8),
+              m_pixel_format(PixelFormat::Mono8),
+              m_requested_pixel_format(PixelFormat::Unknown),
+              m_raw_size(0),
+              m_frame_pool_size(0),
+              m_publish_sequence(0),
+              m_flat_field_enabled(false),
+              m_statistics_enabled(false),
+              m_statistics_subsample(4),
+              m_pipeline(nullptr),
+              m_auto_exposure_running(false),
+              m_auto_exposure_skip_until(0),
+              m_shared_memory_running(false),
+              m_shared_memory_dropped(0) {
+        qRegisterMetaType<FrameRef>("FrameRef");
+        qRegisterMetaType<FocusResult>("FocusResult");
+
+        m_update_image_signal = QMetaMethod::fromSignal(&CameraController::signalUpdateImage);
+
+        connect(&m_metrics_log_timer, &QTimer::timeout, this, [this]() {
+            std::cout << "[Camera " << m_backend->serialNumber() << "] "
+                      << acquisitionProfileName(m_profile.profile) << " "
+                      << FrameMetrics::format(m_metrics.snapshot(true)) << std::endl;
+        });
+
+        if (!m_backend) {
+#ifdef NO_GALAXY_CAMERA
+            m_backend.reset(new SyntheticCameraBackend());
+#else
+            m_backend.reset(new GalaxyCameraBackend());
+#endif
+        }
     }
 
     ~CameraController() {
+        m_recorder.stop();
+
         if (m_bIsOpen || m_bIsSnap) {
             closeCamera();
         }
-
-        if (m_pCaptureEventHandler != nullptr) {
-            delete m_pCaptureEventHandler;
-            m_pCaptureEventHandler = nullptr;
-        }
     }
 
-public:
+    /**
+     * @brief 单相机场景的默认实例；多相机请使用 CameraManager
+     */
     static CameraController &getInstance() {
         static CameraController instance;  // 局部静态变量，注意生命周期
         return instance;
     }
 
+    std::string getSerialNumber() {
+        return m_backend->serialNumber();
+    }
+
+    /**
+     * @brief 替换相机后端（如模拟或回放后端），只能在相机关闭时调用
+     */
+    void setBackend(std::unique_ptr<ICameraBackend> backend) {
+        if (m_bIsOpen || m_bIsSnap || !backend) return;
+
+        m_backend = std::move(backend);
+    }
+
+    ICameraBackend *getBackend() {
+        return m_backend.get();
+    }
+
     bool isCameraOpen() {
         return (m_bIsOpen && m_bIsSnap);
     }
 
+    /**
+     * @brief 设备是否已打开（不论是否在采集，stopGrab() 之后仍为 true）
+     */
+    bool isDeviceOpen() {
+        return m_bIsOpen;
+    }
+
+    /**
+     * @brief 打开设备并开始采集；设备已打开时直接返回，暂停的采集由 startGrab() 恢复
+     */
     void openCamera() {
-        std::lock_guard<std::mutex> locker(m_image_mutex);
+        if (m_bIsOpen) return;
+
+        std::lock_guard<std::mutex> locker(m_read_mutex);
 
         // 打开设备
-        openDevice();
+        m_bIsOpen = m_backend->open();
 
         if (!m_bIsOpen) return;
 
+        // 协商像素格式
+        if (!negotiatePixelFormat()) {
+            m_backend->close();
+            m_bIsOpen = false;
+            return;
+        }
+
+        // 图像数据内存空间初始化（须在开始采集之前完成，采集回调不再加锁）
+        allocateBuffers();
+        m_publish_sequence = 0;
+        m_metrics.reset();
+        m_trigger_matcher.reset();
+        forgetParameters();
+
         // 开始采集
-        startSnap();
+        m_backend->setStreamBuffering(m_profile.stream);
+        startConverter();
+        m_bIsSnap = m_backend->start([this](const RawFrame &raw_frame) {
+            onFrameCaptured(raw_frame);
+        });
+    }
 
+    /**
+     * @brief 在不关闭设备的情况下暂停采集
+     */
+    void stopGrab() {
         if (!m_bIsSnap) return;
 
-        // 图像数据内存空间初始化
-        m_image_height = m_objFeatureControlPtr->GetIntFeature("Height")->GetValue();
-        m_image_width = m_objFeatureControlPtr->GetIntFeature("Width")->GetValue();
-        m_buffer_size = m_image_height * m_image_width;
-        m_pBuffer.resize(m_buffer_size);
+        m_recorder.stop();
+        m_accumulator.stop();
+        stopSharedMemory();
+        stopAutoExposure();
+        m_backend->stop();
+        m_converter.stop();
+        m_bIsSnap = false;
+
+        // 等待中的 triggerAndWait() 立即返回空帧
+        m_trigger_matcher.reset();
+    }
+
+    /**
+     * @brief 恢复 stopGrab() 暂停的采集
+     */
+    void startGrab() {
+        if (!m_bIsOpen || m_bIsSnap) return;
+
+        startConverter();
+        m_bIsSnap = m_backend->start([this](const RawFrame &raw_frame) {
+            onFrameCaptured(raw_frame);
+        });
     }
 
     void closeCamera() {
+        if (!m_bIsOpen && !m_bIsSnap) return;
+
+        saveProfileStats();
+
+        // 停止录制
+        m_recorder.stop();
+        m_accumulator.stop();
+        stopSharedMemory();
+        stopAutoExposure();
+
         // 停止采集
-        stopSnap();
+        m_backend->stop();
+        m_converter.stop();
+        m_bIsSnap = false;
+        m_trigger_matcher.reset();
 
         // 关闭设备
-        closeDevice();
+        m_backend->close();
+        m_bIsOpen = false;
+        forgetParameters();
+
+        std::lock_guard<std::mutex> locker(m_read_mutex);
+        m_frame_buffer.forEach([](FrameRef &frame) {
+            frame.reset();
+        });
+        m_frame_buffer.reset();
+        m_has_image = false;
+
+        // 仍被消费者持有的帧会在其释放后随旧池一起析构
+        m_frame_pool.release();
+        m_raw_pool.release();
+    }
+
+    /**
+     * @brief 读取相机当前的 ROI、合并与抽点设置
+     */
+    ImageGeometry getGeometry() {
+        ImageGeometry geometry;
+        if (!m_bIsOpen) return geometry;
+
+        auto read = [this](const char *name, int default_value) -> int {
+            try {
+                if (m_backend->hasFeature(name)) return (int) m_backend->getIntFeature(name);
+            } catch (...) {}
+            return default_value;
+        };
+
+        geometry.offset_x = read("OffsetX", 0);
+        geometry.offset_y = read("OffsetY", 0);
+        geometry.width = read("Width", 0);
+        geometry.height = read("Height", 0);
+        geometry.binning_horizontal = read("BinningHorizontal", 1);
+        geometry.binning_vertical = read("BinningVertical", 1);
+        geometry.decimation_horizontal = read("DecimationHorizontal", 1);
+        geometry.decimation_vertical = read("DecimationVertical", 1);
+
+        return geometry;
+    }
+
+    /**
+     * @brief 在相机打开时修改 ROI、合并与抽点
+     *
+     * 暂停采集，按相机的取值范围与步进对齐后写入，重新分配帧池后恢复采集，并发出 signalGeometryChanged()。
+     * 修改期间不会有新帧发布；仍被消费者持有的旧尺寸帧保持有效。正在进行的录制会被停止（文件尺寸固定）。
+     * 设置失败时恢复原设置。
+     *
+     * @return 是否全部设置成功
+     */
+    bool setGeometry(const ImageGeometry &geometry) {
+        if (!m_bIsOpen) return false;
+
+        bool was_grabbing = m_bIsSnap;
+        stopGrab();
+
+        ImageGeometry previous = getGeometry();
+        bool ok = applyGeometry(geometry);
+        if (!ok) {
+            std::cout << "Set camera geometry error!" << std::endl;
+            applyGeometry(previous);
+        }
+
+        {
+            std::lock_guard<std::mutex> locker(m_read_mutex);
+            allocateBuffers();
+        }
 
-        m_pBuffer.clear();
+        if (was_grabbing) startGrab();
+
+        emit signalGeometryChanged(m_image_width, m_image_height);
+
+        return ok;
     }
 
+    /**
+     * @brief 设置 ROI（合并、抽点后的像素坐标），width / height 为 0 表示到传感器边缘
+     */
+    bool setRoi(int offset_x, int offset_y, int width, int height) {
+        ImageGeometry geometry = getGeometry();
+        geometry.offset_x = offset_x;
+        geometry.offset_y = offset_y;
+        geometry.width = width;
+        geometry.height = height;
+
+        return setGeometry(geometry);
+    }
+
+    /**
+     * @brief 恢复全画幅
+     */
+    bool resetRoi() {
+        return setRoi(0, 0, 0, 0);
+    }
+
+    /**
+     * @brief 设置合并倍数，ROI 恢复为全画幅
+     */
+    bool setBinning(int horizontal, int vertical) {
+        ImageGeometry geometry = getGeometry();
+        geometry.binning_horizontal = horizontal;
+        geometry.binning_vertical = vertical;
+        geometry.offset_x = geometry.offset_y = geometry.width = geometry.height = 0;
+
+        return setGeometry(geometry);
+    }
+
+    /**
+     * @brief 设置抽点倍数，ROI 恢复为全画幅
+     */
+    bool setDecimation(int horizontal, int vertical) {
+        ImageGeometry geometry = getGeometry();
+        geometry.decimation_horizontal = horizontal;
+        geometry.decimation_vertical = vertical;
+        geometry.offset_x = geometry.offset_y = geometry.width = geometry.height = 0;
+
+        return setGeometry(geometry);
+    }
+
+    /**
+     * @brief 进入软触发模式；丢弃连续采集时残留的帧，之前回调的帧不会与之后的触发匹配
+     */
     void enterTriggerMode() {
-        m_objFeatureControlPtr->GetEnumFeature("TriggerSelector")->SetValue("FrameStart");
-        m_objFeatureControlPtr->GetEnumFeature("TriggerSource")->SetValue("Software");
-        m_objFeatureControlPtr->GetEnumFeature("TriggerMode")->SetValue("On");
+        if (!m_bIsOpen) return;
+
+        forgetParameters({"TriggerMode", "TriggerSource"});
+        m_backend->enterTriggerMode();
+        m_backend->flushQueue();
+        m_trigger_matcher.reset(FrameMetrics::now());
+        m_bIsTriggerMode = true;
     }
 
     void exitTriggerMode() {
-        m_objFeatureControlPtr->GetEnumFeature("TriggerSelector")->SetValue("FrameStart");
-        m_objFeatureControlPtr->GetEnumFeature("TriggerMode")->SetValue("Off");
+        if (!m_bIsOpen) return;
+
+        forgetParameters({"TriggerMode"});
+        m_backend->exitTriggerMode();
+        m_bIsTriggerMode = false;
+        m_trigger_matcher.reset();
+    }
+
+    bool isTriggerMode() {
+        return m_bIsTriggerMode;
+    }
+
+    /**
+     * @brief 发送一次软触发，返回的 future 在该次触发产生的帧到达时就绪
+     *
+     * 帧按 SDK 帧号与触发一一对应；对应的帧丢失、超时或采集停止时 future 得到空句柄。
+     * 可以连续调用多次以流水线方式触发。需先调用 enterTriggerMode()。
+     */
+    std::future<FrameRef> triggerAsync(int timeout_ms = 1000) {
+        if (!m_bIsOpen || !m_bIsSnap || !m_bIsTriggerMode) {
+            std::promise<FrameRef> promise;
+            promise.set_value(FrameRef());
+            return promise.get_future();
+        }
+
+        // 先登记再触发，避免帧先于登记到达
+        std::future<FrameRef> future = m_trigger_matcher.addTrigger(timeout_ms);
+        m_backend->softwareTrigger();
+
+        return future;
+    }
+
+    /**
+     * @brief 发送一次软触发并阻塞等待该次触发产生的帧
+     * @return 超时、帧丢失或不在触发模式时返回空句柄
+     */
+    FrameRef triggerAndWait(int timeout_ms = 1000) {
+        std::future<FrameRef> future = triggerAsync(timeout_ms);
+        if (future.wait_for(std::chrono::milliseconds(timeout_ms)) != std::future_status::ready) {
+            return FrameRef();
+        }
+
+        FrameRef frame = future.get();
+        recordFramePickup(frame);
+
+        return frame;
     }
 
     int getImageWidth() {
@@ -101,289 +438,1111 @@ public:
         return m_buffer_size;
     }
 
+    /**
+     * @brief 输出帧的 OpenCV 类型：CV_8UC1、CV_16UC1（高位对齐）或 CV_8UC3（RGB）
+     */
+    int getImageType() {
+        return m_image_cv_type;
+    }
+
+    /**
+     * @brief 当前相机的像素格式（打开相机时协商）
+     */
+    PixelFormat getPixelFormat() {
+        return m_pixel_format;
+    }
+
+    /**
+     * @brief 设置期望的像素格式，在下次打开相机时生效；相机不支持时沿用相机当前格式
+     */
+    void setPixelFormat(PixelFormat format) {
+        m_requested_pixel_format = format;
+    }
+
+    /**
+     * @brief 获取最新一帧的句柄（零拷贝），句柄释放后帧对象归还帧池
+     */
+    FrameRef getFrame() {
+        if (!m_bIsOpen || !m_bIsSnap) return FrameRef();
+
+        // 只在读端之间串行化，不会阻塞采集回调
+        std::lock_guard<std::mutex> locker(m_read_mutex);
+
+        if (m_frame_buffer.update()) m_has_image = true;
+        if (!m_has_image) return FrameRef();
+
+        FrameRef frame = m_frame_buffer.readBuffer();
+        recordFramePickup(frame);
+
+        return frame;
+    }
+
+    /**
+     * @brief 获取最新一帧的深拷贝，兼容旧接口；无需拷贝时请使用 getFrame()
+     */
     cv::Mat getImage() {
-        if (!m_bIsOpen || !m_bIsSnap) return cv::Mat();
+        FrameRef frame = getFrame();
+        if (!frame) return cv::Mat();
+
+        return frame.mat().clone();
+    }
+
+    uint64_t getDroppedFrameCount() {
+        FrameMetrics::Snapshot snapshot = m_metrics.snapshot();
+        return snapshot.sdk_dropped + snapshot.pool_dropped + snapshot.convert_dropped;
+    }
+
+    /**
+     * @brief 采集链路的延迟直方图与丢帧计数
+     */
+    FrameMetrics &getFrameMetrics() {
+        return m_metrics;
+    }
+
+    /**
+     * @brief 由通过信号接收帧的消费者调用，记录取帧时间（getFrame() 已自动记录）
+     */
+    void recordFramePickup(const FrameRef &frame) {
+        if (frame) m_metrics.recordPickup(frame->timing, frame->sequence);
+    }
+
+    /**
+     * @brief 由显示控件在绘制帧时调用，记录显示时间
+     */
+    void recordFramePaint(const FrameRef &frame) {
+        if (frame) m_metrics.recordPaint(frame->timing);
+    }
+
+    /**
+     * @brief 周期性输出统计日志（滚动直方图），msec <= 0 时关闭
+     */
+    void setMetricsLogInterval(int msec) {
+        if (msec <= 0) {
+            m_metrics_log_timer.stop();
+            return;
+        }
+
+        m_metrics_log_timer.start(msec);
+    }
+
+    /**
+     * @brief 切换采集配置（SDK 缓冲策略、帧池大小与转换队列深度），相机已打开时短暂停止采集并重新分配帧池
+     *
+     * 切换前的统计保存为原配置的统计，之后延迟与丢帧统计重新开始，见 getAcquisitionProfileStats()。
+     * setFramePoolSize() 设置的帧池大小优先于配置中的帧池大小。
+     */
+    void setAcquisitionProfile(const AcquisitionProfileSettings &settings) {
+        if (!m_bIsOpen) {
+            m_profile = settings;
+            return;
+        }
+
+        bool was_grabbing = m_bIsSnap;
+        stopGrab();
+
+        saveProfileStats();
+        m_profile = settings;
+        m_backend->setStreamBuffering(m_profile.stream);
+
+        {
+            std::lock_guard<std::mutex> locker(m_read_mutex);
+            allocateBuffers();
+        }
+        m_metrics.reset();
+        m_trigger_matcher.reset();
+
+        if (was_grabbing) startGrab();
+    }
+
+    void setAcquisitionProfile(AcquisitionProfile profile) {
+        setAcquisitionProfile(AcquisitionProfileSettings::preset(profile));
+    }
+
+    AcquisitionProfileSettings getAcquisitionProfile() {
+        return m_profile;
+    }
+
+    /**
+     * @brief 某一采集配置的延迟与丢帧统计：当前配置返回实时统计，其它配置返回最近一次使用时的统计
+     */
+    FrameMetrics::Snapshot getAcquisitionProfileStats(AcquisitionProfile profile) {
+        if (m_bIsOpen && profile == m_profile.profile) return m_metrics.snapshot();
+
+        return m_profile_stats[(int) profile];
+    }
+
+    /**
+     * @brief 设置帧池大小，0 表示按内存预算自动计算；在下次打开相机时生效
+     */
+    void setFramePoolSize(size_t frame_count) {
+        m_frame_pool_size = frame_count;
+    }
+
+    size_t getFramePoolSize() {
+        return m_frame_pool.frameCount();
+    }
+
+    /**
+     * @brief 开始将采集到的每一帧录制到帧序列文件
+     * @param path - 帧序列文件路径
+     * @param capacity_frames - 预分配的帧数，写满后后续帧计入 dropped_file_full
+     * @param queue_capacity - 写盘队列容量，0 表示使用采集配置的默认值；会被限制在帧池大小以内，保证实时显示仍有可用帧
+     */
+    bool startRecording(const std::string &path, uint64_t capacity_frames, size_t queue_capacity = 0) {
+        if (!m_bIsOpen || !m_bIsSnap) return false;
+
+        if (queue_capacity == 0) queue_capacity = std::max<size_t>(m_profile.recording_queue_capacity, 1);
+
+        size_t pool_size = m_frame_pool.frameCount();
+        size_t max_queue = pool_size > 4 ? pool_size - 4 : 1;
+        if (queue_capacity > max_queue) queue_capacity = max_queue;
+
+        return m_recorder.start(path, m_image_width, m_image_height, m_image_cv_type, m_image_step,
+                                capacity_frames, queue_capacity);
+    }
+
+    /**
+     * @brief 在后台保存最新一帧，立即返回；编码与写盘在导出线程池中进行
+     *
+     * 导出服务未启动时按默认设置启动，可通过 getImageExporter() 设置格式、压缩与队列策略。
+     *
+     * @return 没有可用帧或被导出队列拒绝时返回 false
+     */
+    bool saveImageAsync(const std::string &path) {
+        FrameRef frame = getFrame();
+        if (!frame) return false;
+
+        return saveFrameAsync(frame, path);
+    }
+
+    /**
+     * @brief 在后台保存指定的帧（如 triggerAndWait() 返回的帧）
+     */
+    bool saveFrameAsync(const FrameRef &frame, const std::string &path) {
+        // 多个线程可能同时首次保存，由导出器保证只启动一次
+        m_exporter.ensureStarted();
+
+        return m_exporter.submit(frame, path);
+    }
+
+    ImageExporter &getImageExporter() {
+        return m_exporter;
+    }
+
+    /**
+     * @brief 把之后发布的每一帧写入共享内存环形缓冲区，供其它进程通过 SharedFrameRingReader 读取
+     *
+     * 写入在独立线程中进行，不阻塞采集；跟不上帧率时跳过部分帧，见 getSharedMemoryDroppedCount()。
+     * 暂停采集（包括修改 ROI）会停止发布，读端收到 SharedFrameStatus::Closed 后应重新打开。
+     *
+     * @param name - 共享内存对象名，为空时使用 "/camera_<序列号>"
+     * @param slot_count - 槽位数，即读端允许的最大滞后帧数
+     * @param mode - 共享内存对象的访问权限，见 SharedFrameRingPublisher::create()
+     */
+    bool startSharedMemory(const std::string &name = std::string(), uint32_t slot_count = 8,
+                           unsigned int mode = 0600) {
+        if (!m_bIsOpen || !m_bIsSnap) return false;
+
+        // stopSharedMemory() 返回时写入线程已退出、发布线程已不在入队，之后重建共享内存与队列是安全的
+        stopSharedMemory();
+
+        std::string ring_name = name.empty() ? defaultSharedMemoryName() : name;
+        if (!m_shared_ring.create(ring_name, slot_count, (uint64_t) m_buffer_size, mode)) return false;
+
+        m_shared_memory_dropped = 0;
+        m_shared_memory_worker.start([this](const FrameRef &frame) {
+            m_shared_ring.publish(frame.mat(), frame->frame_id, frame->timestamp);
+        }, 2);
+        m_shared_memory_running = true;
+
+        return true;
+    }
+
+    void stopSharedMemory() {
+        m_shared_memory_running = false;
+        m_shared_memory_worker.stop();
+        m_shared_ring.close();
+    }
+
+    bool isSharedMemoryPublishing() {
+        return m_shared_memory_running;
+    }
+
+    std::string getSharedMemoryName() {
+        return m_shared_ring.name();
+    }
+
+    uint64_t getSharedMemoryDroppedCount() {
+        return m_shared_memory_dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 把每一帧已发布的帧送入处理流水线（不阻塞采集线程），传入 nullptr 取消
+     *
+     * 流水线由调用方创建、启动并管理生命周期；更换或移除流水线前应先 stopGrab()，或保证流水线晚于本控制器析构。
+     */
+    void setPipeline(FramePipeline *pipeline) {
+        m_pipeline.store(pipeline, std::memory_order_release);
+    }
+
+    FramePipeline *getPipeline() {
+        return m_pipeline.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 对之后发布的每一帧计算清晰度，结果通过 signalFocusScore() 发出（在评价线程中发出）
+     *
+     * 评价在独立线程中进行，不阻塞采集；跟不上帧率时跳过部分帧，见 getFocusDroppedCount()。
+     * 对指定的帧（如 triggerAndWait() 返回的帧）可直接调用 FocusEngine::measure()。
+     *
+     * @param roi - 评价区域（帧坐标），空区域表示整帧
+     * @param subsample - 降采样倍数，大画幅下用于换取帧率
+     */
+    void startFocusMeasure(FocusMeasure measure = FocusMeasure::VarianceOfLaplacian, const cv::Rect &roi = cv::Rect(),
+                           int subsample = 1) {
+        m_focus_engine.setMeasure(measure);
+        m_focus_engine.setRoi(roi);
+        m_focus_engine.setSubsample(subsample);
+        m_focus_engine.start([this](const FocusResult &result) {
+            emit signalFocusScore(result);
+        });
+    }
+
+    void stopFocusMeasure() {
+        m_focus_engine.stop();
+    }
+
+    bool isFocusMeasuring() {
+        return m_focus_engine.isRunning();
+    }
+
+    void setFocusRoi(const cv::Rect &roi) {
+        m_focus_engine.setRoi(roi);
+    }
+
+    FocusResult getFocusResult() {
+        return m_focus_engine.latestResult();
+    }
+
+    uint64_t getFocusDroppedCount() {
+        return m_focus_engine.droppedCount();
+    }
+
+    void stopRecording() {
+        m_recorder.stop();
+    }
+
+    /**
+     * @brief 标定第一步：遮光后采集 count 帧的均值作为暗场参考帧
+     *
+     * 采集期间暂停校正；之后调用 calibrateFlat()。不需要暗场校正时可跳过此步。
+     */
+    bool calibrateDark(int count = 16, int timeout_ms = 10000) {
+        cv::Mat dark = grabCalibrationReference(count, timeout_ms);
+        if (dark.empty()) return false;
+
+        std::lock_guard<std::mutex> locker(m_flat_field_mutex);
+        m_flat_field_dark = dark;
+
+        return true;
+    }
 
-        std::lock_guard<std::mutex> locker(m_image_mutex);
+    /**
+     * @brief 标定第二步：均匀照明（不饱和）下采集 count 帧的均值作为平场参考帧，计算校正图并启用校正
+     *
+     * 暗场尺寸与当前帧不一致（如修改了 ROI）时不使用暗场。
+     */
+    bool calibrateFlat(int count = 16, int timeout_ms = 10000) {
+        cv::Mat flat = grabCalibrationReference(count, timeout_ms);
+        if (flat.empty()) return false;
+
+        cv::Mat dark;
+        {
+            std::lock_guard<std::mutex> locker(m_flat_field_mutex);
+            if (m_flat_field_dark.rows == flat.rows && m_flat_field_dark.cols == flat.cols &&
+                m_flat_field_dark.type() == flat.type()) {
+                dark = m_flat_field_dark;
+            }
+        }
+
+        auto correction = std::make_shared<FlatFieldCorrection>();
+        if (!correction->create(dark, flat, m_backend->serialNumber())) return false;
+
+        setFlatField(correction);
+        setFlatFieldEnabled(true);
+
+        return true;
+    }
+
+    /**
+     * @brief 替换校正图，传入 nullptr 清除；与当前帧尺寸或类型不一致的校正图不生效
+     */
+    void setFlatField(std::shared_ptr<const FlatFieldCorrection> correction) {
+        std::lock_guard<std::mutex> locker(m_flat_field_mutex);
+        m_flat_field = std::move(correction);
+    }
+
+    std::shared_ptr<const FlatFieldCorrection> getFlatField() {
+        std::lock_guard<std::mutex> locker(m_flat_field_mutex);
+        return m_flat_field;
+    }
+
+    void setFlatFieldEnabled(bool enabled) {
+        m_flat_field_enabled = enabled;
+    }
+
+    bool isFlatFieldEnabled() {
+        return m_flat_field_enabled;
+    }
+
+    /**
+     * @brief 保存校正图到 directory/flat_field_<序列号>.ffc
+     */
+    bool saveFlatField(const std::string &directory) {
+        std::shared_ptr<const FlatFieldCorrection> correction = getFlatField();
+        if (!correction) return false;
+
+        return correction->save(flatFieldPath(directory));
+    }
+
+    /**
+     * @brief 加载本相机的校正图并启用校正，文件中的序列号必须与相机一致
+     */
+    bool loadFlatField(const std::string &directory) {
+        auto correction = std::make_shared<FlatFieldCorrection>();
+        if (!correction->load(flatFieldPath(directory), m_backend->serialNumber())) return false;
+
+        if (m_bIsOpen && !correction->matches(m_image_width, m_image_height, m_image_cv_type)) {
+            std::cout << "Flat field size or pixel format does not match current frame" << std::endl;
+        }
+
+        setFlatField(correction);
+        setFlatFieldEnabled(true);
+
+        return true;
+    }
+
+    /**
+     * @brief 多帧累加降噪：每 N 帧（Block）或每帧（Rolling）输出一帧均值或中值，通过 signalAccumulatedFrame() 发出
+     *
+     * 累加在独立线程中进行，不阻塞采集与实时显示。Rolling 与中值模式需要持有 N 帧，
+     * N 不能超过 getAccumulationMaxHeldCount()（帧池大小减去采集与显示占用的帧），
+     * 超过时返回 false；需要更大的 N 时先 setFramePoolSize() 并重新打开相机。
+     * 暂停采集（包括修改 ROI）会停止累加。
+     */
+    bool startAccumulation(const FrameAccumulator::Settings &settings) {
+        if (!m_bIsOpen || !m_bIsSnap) return false;
+
+        size_t max_held = getAccumulationMaxHeldCount();
+        bool holds_frames = settings.mode == FrameAccumulator::Mode::Rolling ||
+                            settings.method == FrameAccumulator::Method::Median;
+        if (holds_frames && settings.count > (int) max_held) {
+            std::cout << "Accumulation count " << settings.count << " exceeds frame pool limit "
+                      << max_held << "!" << std::endl;
+            return false;
+        }
+
+        m_accumulator.start(settings, [this](const FrameRef &result) {
+            emit signalAccumulatedFrame(result);
+        }, max_held);
+
+        return true;
+    }
+
+    void stopAccumulation() {
+        m_accumulator.stop();
+    }
+
+    /**
+     * @brief Rolling 与中值模式下 N 的上限：帧池中留出 6 帧给采集、转换与显示，其余可由累加持有
+     */
+    size_t getAccumulationMaxHeldCount() {
+        size_t pool_size = m_frame_pool.frameCount();
+        return pool_size > 6 ? pool_size - 6 : 1;
+    }
+
+    bool isAccumulating() {
+        return m_accumulator.isRunning();
+    }
+
+    /**
+     * @brief 实际使用的累加设置（N 可能被限制）
+     */
+    FrameAccumulator::Settings getAccumulationSettings() {
+        return m_accumulator.settings();
+    }
+
+    FrameRef getAccumulatedFrame() {
+        return m_accumulator.latestResult();
+    }
+
+    uint64_t getAccumulationDroppedCount() {
+        return m_accumulator.droppedCount();
+    }
+
+    /**
+     * @brief 采集并返回一帧 count 帧的均值或中值（低噪声单帧），阻塞约 count 个帧周期
+     *
+     * 会替换正在进行的累加设置，返回后停止累加。不能在接收 signalAccumulatedFrame() 的槽中调用。
+     *
+     * @return 超时、未在采集或中值模式的 count 超过 getAccumulationMaxHeldCount() 时返回空帧
+     */
+    FrameRef grabAccumulated(int count, FrameAccumulator::Method method = FrameAccumulator::Method::Mean,
+                             int timeout_ms = 5000) {
+        FrameAccumulator::Settings settings;
+        settings.count = count;
+        settings.method = method;
+        settings.mode = FrameAccumulator::Mode::Block;
+        if (!startAccumulation(settings)) return FrameRef();
+
+        FrameRef result = m_accumulator.waitResult(timeout_ms);
+        m_accumulator.stop();
+
+        return result;
+    }
 
-        return cv::Mat(m_image_height, m_image_width, CV_8UC1, m_pBuffer.data()).clone();
+    bool isRecording() {
+        return m_recorder.isRecording();
     }
 
-    std::mutex &getImageMutex() {
-        return m_image_mutex;
+    FrameRecorder::Stats getRecorderStats() {
+        return m_recorder.stats();
     }
 
-    std::vector<uint8_t> &getBuffer() {
-        return m_pBuffer;
+    /**
+     * @brief 一次批量写入一组参数（如切换产品配方）
+     *
+     * 特征节点由后端在打开相机时解析并缓存。skip_unchanged 为 true 时，跳过与上次经本接口写入或读回的值相同的参数，
+     * 只写入有变化的部分；通过其它接口（如 setExposureTimeUs()、自动曝光）修改过的参数会重新写入。
+     *
+     * @param failed - 不为空时返回写入失败的参数名
+     * @return 是否全部写入成功
+     */
+    bool applyParameters(const CameraParameterSet &parameters, bool skip_unchanged = true,
+                         std::vector<std::string> *failed = nullptr) {
+        if (!m_bIsOpen) return false;
+
+        CameraParameterSet changes;
+        {
+            std::lock_guard<std::mutex> locker(m_parameter_mutex);
+            for (const CameraParameterSet::Entry &entry : parameters.entries()) {
+                const CameraParameterSet::Entry *known = m_known_parameters.find(entry.name);
+                if (skip_unchanged && known && known->sameValue(entry)) continue;
+
+                changes.set(entry);
+            }
+        }
+        if (changes.empty()) return true;
+
+        std::vector<std::string> failed_names;
+        bool ok = m_backend->applyParameters(changes, &failed_names);
+
+        {
+            std::lock_guard<std::mutex> locker(m_parameter_mutex);
+            for (const CameraParameterSet::Entry &entry : changes.entries()) {
+                bool entry_failed = std::find(failed_names.begin(), failed_names.end(), entry.name) != failed_names.end();
+                if (entry_failed || entry.type == CameraParameterSet::Type::Command) {
+                    m_known_parameters.remove(entry.name);
+                } else {
+                    m_known_parameters.set(entry);
+                }
+            }
+        }
+
+        if (!ok) {
+            std::cout << "Apply camera parameters error:";
+            for (const std::string &name : failed_names) std::cout << " " << name;
+            std::cout << std::endl;
+        }
+        if (failed) failed->insert(failed->end(), failed_names.begin(), failed_names.end());
+
+        return ok;
+    }
+
+    /**
+     * @brief 按 layout 中的参数名与类型读回相机当前值
+     */
+    CameraParameterSet readParameters(const CameraParameterSet &layout) {
+        if (!m_bIsOpen) return CameraParameterSet();
+
+        CameraParameterSet values = m_backend->readParameters(layout);
+        {
+            std::lock_guard<std::mutex> locker(m_parameter_mutex);
+            m_known_parameters.merge(values);
+        }
+
+        return values;
+    }
+
+    /**
+     * @brief 读回全部常用设置的快照，可直接作为配方传给 applyParameters()
+     */
+    CameraParameterSet snapshotParameters() {
+        return readParameters(CameraParameterSet::standardParameters());
     }
 
     double getExposureTimeUs() {
-        return m_objFeatureControlPtr->GetFloatFeature("ExposureTime")->GetValue();
+        if (!m_bIsOpen) return 0;
+
+        return m_backend->getFloatFeature("ExposureTime");
     }
 
     void setExposureTimeUs(double exposure_time_us) {
         if (!m_bIsOpen || !m_bIsSnap) return;
 
-        if ((exposure_time_us < 1000) || (exposure_time_us > 1000000)) return;
+        if ((exposure_time_us < kMinExposureUs) || (exposure_time_us > kMaxExposureUs)) return;
 
-        m_objFeatureControlPtr->GetFloatFeature("ExposureTime")->SetValue(exposure_time_us);
+        forgetParameters({"ExposureTime"});
+        m_backend->setFloatFeature("ExposureTime", exposure_time_us);
     }
 
     double getExposureGainDB() {
-        return m_objFeatureControlPtr->GetFloatFeature("Gain")->GetValue();
+        if (!m_bIsOpen) return 0;
+
+        return m_backend->getFloatFeature("Gain");
     }
 
     void setExposureGainDB(double exposure_gain_dB) {
         if (!m_bIsOpen || !m_bIsSnap) return;
 
-        if ((exposure_gain_dB < 0) || (exposure_gain_dB > 24)) return;
+        if ((exposure_gain_dB < kMinGainDB) || (exposure_gain_dB > kMaxGainDB)) return;
 
-        m_objFeatureControlPtr->GetFloatFeature("Gain")->SetValue(exposure_gain_dB);
+        forgetParameters({"Gain"});
+        m_backend->setFloatFeature("Gain", exposure_gain_dB);
     }
 
     void setAutoExposureOnce(int wait_msec = 1000) {
         if (!m_bIsOpen || !m_bIsSnap) return;
 
-        m_objFeatureControlPtr->GetEnumFeature("ExposureAuto")->SetValue("Once");
+        forgetParameters({"ExposureAuto", "ExposureTime"});
+        m_backend->setEnumFeature("ExposureAuto", "Once");
 
         QTimer::singleShot(wait_msec, [=]() {
             emit signalAutoExposureTimeUs(getExposureTimeUs());
         });
     }
 
+    /**
+     * @brief 在发布每一帧之前计算灰度统计并写入 Frame::statistics，所有消费者直接读取
+     *
+     * 统计在发布线程中一次遍历完成，开销随采样间隔的平方下降。区域与采样间隔和自动曝光的测光设置
+     * 相同时，自动曝光直接复用该结果。
+     *
+     * @param roi - 统计区域（帧坐标），空区域表示整帧
+     * @param subsample - 行列采样间隔
+     */
+    void setFrameStatistics(bool enabled, const cv::Rect &roi = cv::Rect(), int subsample = 4) {
+        std::lock_guard<std::mutex> locker(m_statistics_mutex);
+        m_statistics_roi = roi;
+        m_statistics_subsample = std::max(subsample, 1);
+        m_statistics_enabled = enabled;
+    }
+
+    bool isFrameStatisticsEnabled() {
+        return m_statistics_enabled;
+    }
+
+    /**
+     * @brief 启动软件自动曝光：按每帧的亮度直方图调整曝光时间与增益
+     *
+     * 统计与调整在独立线程中进行，不阻塞采集；每次调整后跳过已在曝光中的帧，通常几帧内收敛。
+     * 收敛、到达边界或超过最大调整次数时发出 signalAutoExposureConverged() 与 signalAutoExposureTimeUs()；
+     * 非连续模式下随即停止。曝光时间与增益的范围会被限制在 setExposureTimeUs() / setExposureGainDB() 的范围内。
+     * 暂停采集（包括修改 ROI）会停止自动曝光。
+     */
+    bool startAutoExposure(const AutoExposureSettings &settings = AutoExposureSettings()) {
+        if (!m_bIsOpen || !m_bIsSnap) return false;
+
+        stopAutoExposure();
+
+        AutoExposureSettings clamped = settings;
+        clamped.min_exposure_us = std::max(clamped.min_exposure_us, kMinExposureUs);
+        clamped.max_exposure_us = std::min(clamped.max_exposure_us, kMaxExposureUs);
+        clamped.min_gain_db = std::max(clamped.min_gain_db, kMinGainDB);
+        clamped.max_gain_db = std::min(clamped.max_gain_db, kMaxGainDB);
+        if (clamped.min_exposure_us > clamped.max_exposure_us || clamped.min_gain_db > clamped.max_gain_db) {
+            return false;
+        }
+
+        // 相机自带的自动曝光会覆盖软件写入的曝光时间与增益
+        forgetParameters({"ExposureAuto", "GainAuto", "ExposureTime", "Gain"});
+        try {
+            m_backend->setEnumFeature("ExposureAuto", "Off");
+            m_backend->setEnumFeature("GainAuto", "Off");
+        } catch (...) {}
+
+        // stopAutoExposure() 返回时自动曝光线程已退出、发布线程已不在入队，这里可以安全地重置算法状态与队列
+        m_auto_exposure.reset(clamped, getExposureTimeUs(), getExposureGainDB());
+        m_auto_exposure_skip_until = 0;
+        m_auto_exposure_worker.start([this](const FrameRef &frame) {
+            onAutoExposureFrame(frame);
+        }, 1);
+        m_auto_exposure_running = true;
+
+        return true;
+    }
+
+    void stopAutoExposure() {
+        m_auto_exposure_running = false;
+        m_auto_exposure_worker.stop();
+    }
+
+    bool isAutoExposureRunning() {
+        return m_auto_exposure_running;
+    }
+
 public slots:
+    /**
+     * @brief 发送一次软触发而不等待结果；触发模式下同样经过触发匹配，不影响 triggerAsync() 的帧对应关系
+     */
     void slotSoftwareTrigger() {
-        m_objFeatureControlPtr->GetCommandFeature("TriggerSoftware")->Execute();
+        if (!m_bIsOpen || !m_bIsSnap) return;
+
+        if (m_bIsTriggerMode) {
+            triggerAsync();
+        } else {
+            m_backend->softwareTrigger();
+        }
     }
 
 signals:
+    // QImage 持有帧句柄，帧对象在最后一个 QImage 副本析构前不会被复用；只在有连接时构造并发出
     void signalUpdateImage(QImage);
 
+    void signalUpdateFrame(FrameRef);
+
     void signalAutoExposureTimeUs(double);
 
+    // 软件自动曝光结束（或连续模式下状态改变）；converged 为 false 表示到达边界或未能收敛
+    void signalAutoExposureConverged(bool converged, double exposure_time_us, double gain_dB);
+
+    // 图像尺寸改变（ROI、合并或抽点），之后发布的帧使用新尺寸
+    void signalGeometryChanged(int width, int height);
+
+    // 每一帧的清晰度，frame_id 与 signalUpdateFrame() 中帧的 frame_id 对应
+    void signalFocusScore(FocusResult);
+
+    // 在累加线程中发出
+    void signalAccumulatedFrame(FrameRef);
+
 private:
-    // 用户继承采集事件处理类
-    class CSampleCaptureEventHandler : public ICaptureEventHandler {
-    public:
-        void DoOnImageCaptured(CImageDataPointer &objImageDataPointer, void *pUserParam) {
-            CameraController *camera = static_cast<CameraController *>(pUserParam);
-            std::lock_guard<std::mutex> locker(camera->getImageMutex());
+    static constexpr double kMinExposureUs = 1000;
+    static constexpr double kMaxExposureUs = 1000000;
+    static constexpr double kMinGainDB = 0;
+    static constexpr double kMaxGainDB = 24;
+
+    static QImage::Format qimageFormat(int cv_type) {
+        switch (cv_type) {
+            case CV_16UC1: return QImage::Format_Grayscale16;
+            case CV_8UC3: return QImage::Format_RGB888;
+            default: return QImage::Format_Grayscale8;
+        }
+    }
 
+    /**
+     * @brief 按期望格式设置相机，并确认相机当前格式受支持
+     */
+    bool negotiatePixelFormat() {
+        if (m_requested_pixel_format != PixelFormat::Unknown) {
             try {
-                std::memcpy(camera->getBuffer().data(), objImageDataPointer->GetBuffer(), camera->getBufferSize());
-
-                emit camera->signalUpdateImage(QImage(camera->getBuffer().data(),
-                                                      camera->getImageWidth(),
-                                                      camera->getImageHeight(),
-                                                      QImage::Format_Grayscale8));
-            } catch (CGalaxyException) {
-                // do noting
+                m_backend->setEnumFeature("PixelFormat", pixelFormatName(m_requested_pixel_format));
+            } catch (...) {
+                std::cout << "Camera does not support pixel format " << pixelFormatName(m_requested_pixel_format)
+                          << "!" << std::endl;
             }
         }
-    };
 
-    void paramInit() {
-        // 设置 采集模式 为 连续采集
-        m_objFeatureControlPtr->GetEnumFeature("AcquisitionMode")->SetValue("Continuous");
+        std::string name;
+        try {
+            name = m_backend->getEnumFeature("PixelFormat");
+        } catch (...) {
+            name = "Mono8";
+        }
 
-        // 设置 触发模式 为 关
-        m_objFeatureControlPtr->GetEnumFeature("TriggerMode")->SetValue("Off");
+        m_pixel_format = pixelFormatFromName(name);
+        if (m_pixel_format != PixelFormat::Unknown) return true;
 
-        // 设置 初始曝光时间
-        m_objFeatureControlPtr->GetFloatFeature("ExposureTime")->SetValue(10000);
+        // 尝试退回 Mono8
+        try {
+            m_backend->setEnumFeature("PixelFormat", "Mono8");
+            m_pixel_format = pixelFormatFromName(m_backend->getEnumFeature("PixelFormat"));
+        } catch (...) {}
 
-        // 设置 初始曝光增益
-        m_objFeatureControlPtr->GetFloatFeature("Gain")->SetValue(0);
+        if (m_pixel_format == PixelFormat::Unknown) {
+            std::cout << "Unsupported pixel format " << name << "!" << std::endl;
+            return false;
+        }
+
+        return true;
     }
 
-    void openDevice() {
-        // TODO: Add your control notification handler code here
-        bool bIsDeviceOpen = false;  // 设备开启标志
-        bool bIsStreamOpen = false;  // 流开启标志
+    /**
+     * @brief 按相机当前的尺寸与像素格式分配帧池并清空三缓冲，调用方持有 m_read_mutex 且采集已停止
+     */
+    void allocateBuffers() {
+        m_image_height = (int) m_backend->getIntFeature("Height");
+        m_image_width = (int) m_backend->getIntFeature("Width");
+        m_image_cv_type = pixelFormatOutputType(m_pixel_format);
+        m_image_qformat = qimageFormat(m_image_cv_type);
+        m_image_step = m_image_width * pixelFormatOutputBytesPerPixel(m_pixel_format);
+        m_buffer_size = m_image_step * m_image_height;
+        m_raw_size = pixelFormatRawSize(m_pixel_format, m_image_width, m_image_height);
+
+        size_t pool_size = m_frame_pool_size > 0 ? m_frame_pool_size : m_profile.frame_pool_size;
+        if (pool_size == 0) {
+            pool_size = FramePool::frameCountForBudget(m_buffer_size, m_profile.frame_pool_budget, 6,
+                                                       m_profile.frame_pool_max);
+        }
+        m_frame_pool.allocate(pool_size, m_buffer_size);
 
+        // 需要转换的格式：原始帧池只需容纳转换队列与正在拷贝、转换的帧
+        if (pixelFormatIsPassThrough(m_pixel_format)) {
+            m_raw_pool.release();
+        } else {
+            m_raw_pool.allocate(convertQueueCapacity() + 2, m_raw_size);
+        }
+
+        m_frame_buffer.forEach([](FrameRef &frame) {
+            frame.reset();
+        });
+        m_frame_buffer.reset();
+        m_has_image = false;
+    }
+
+    /**
+     * @brief 按先合并/抽点、再尺寸、最后偏移的顺序写入几何设置，每一步按相机的取值范围与步进对齐
+     */
+    bool applyGeometry(const ImageGeometry &geometry) {
         try {
-            // 枚举设备
-            GxIAPICPP::gxdeviceinfo_vector vectorDeviceInfo;
-            IGXFactory::GetInstance().UpdateDeviceList(1000, vectorDeviceInfo);
-            if (vectorDeviceInfo.size() <= 0) {
-                std::cout << "Device not found!" << std::endl;
-                return;
-            }
+            // 先清零偏移，保证后续尺寸可以取到最大值
+            setAlignedFeature("OffsetX", 0);
+            setAlignedFeature("OffsetY", 0);
+
+            if (!setScaleFeature("BinningHorizontal", geometry.binning_horizontal)) return false;
+            if (!setScaleFeature("BinningVertical", geometry.binning_vertical)) return false;
+            if (!setScaleFeature("DecimationHorizontal", geometry.decimation_horizontal)) return false;
+            if (!setScaleFeature("DecimationVertical", geometry.decimation_vertical)) return false;
+
+            setAlignedFeature("Width", geometry.width > 0 ? geometry.width : INT64_MAX);
+            setAlignedFeature("Height", geometry.height > 0 ? geometry.height : INT64_MAX);
+            setAlignedFeature("OffsetX", geometry.offset_x);
+            setAlignedFeature("OffsetY", geometry.offset_y);
+        } catch (...) {
+            return false;
+        }
 
-            // 打开设备
-            m_objDevicePtr = IGXFactory::GetInstance().OpenDeviceBySN(vectorDeviceInfo[0].GetSN(), GX_ACCESS_EXCLUSIVE);
-            m_objFeatureControlPtr = m_objDevicePtr->GetRemoteFeatureControl();
-            bIsDeviceOpen = true;
+        return true;
+    }
 
-            // 获取流通道个数
-            uint32_t nStreamCount = m_objDevicePtr->GetStreamCount();
-            if (nStreamCount <= 0) {
-                std::cout << "Device stream not found!" << std::endl;
-                return;
-            }
+    // 相机未实现合并 / 抽点时只接受 1 倍
+    bool setScaleFeature(const char *name, int value) {
+        if (!m_backend->hasFeature(name)) return value <= 1;
 
-            // 打开流
-            m_objStreamPtr = m_objDevicePtr->OpenStream(0);
-            m_objStreamFeatureControlPtr = m_objStreamPtr->GetFeatureControl();
-            bIsStreamOpen = true;
-
-            // 建议用户在打开网络相机之后，根据当前网络环境设置相机的流通道包长值，
-            // 以提高网络相机的采集性能,设置方法参考以下代码。
-            GX_DEVICE_CLASS_LIST objDeviceClass = m_objDevicePtr->GetDeviceInfo().GetDeviceClass();
-            if (GX_DEVICE_CLASS_GEV == objDeviceClass) {
-                // 判断设备是否支持流通道数据包功能
-                if (true == m_objFeatureControlPtr->IsImplemented("GevSCPSPacketSize")) {
-                    // 获取当前网络环境的最优包长值
-                    int nPacketSize = m_objStreamPtr->GetOptimalPacketSize();
-                    // 将最优包长值设置为当前设备的流通道包长值
-                    m_objFeatureControlPtr->GetIntFeature("GevSCPSPacketSize")->SetValue(nPacketSize);
-                }
-            }
+        setAlignedFeature(name, value);
+        return m_backend->getIntFeature(name) == value;
+    }
 
-            // 初始化相机参数
-            paramInit();
+    void setAlignedFeature(const char *name, int64_t value) {
+        int64_t min, max, inc;
+        if (m_backend->getIntFeatureRange(name, min, max, inc)) {
+            value = std::min(std::max(value, min), max);
+            if (inc > 1) value = min + (value - min) / inc * inc;
+        }
 
-            m_bIsOpen = true;
-        } catch (CGalaxyException) {
-            std::cout << "Open device galaxy error!" << std::endl;
+        m_backend->setIntFeature(name, value);
+    }
 
-            if (bIsStreamOpen) {
-                m_objStreamPtr->Close();
-            }
+    void startConverter() {
+        if (pixelFormatIsPassThrough(m_pixel_format)) return;
 
-            if (bIsDeviceOpen) {
-                m_objDevicePtr->Close();
-            }
+        m_converter.start([this](const FrameRef &raw_frame) {
+            onRawFrameConverting(raw_frame);
+        }, convertQueueCapacity(), m_profile.convert_overflow);
+    }
 
-            return;
-        } catch (std::exception) {
-            std::cout << "Open device std error!" << std::endl;
+    size_t convertQueueCapacity() {
+        return std::max<size_t>(m_profile.convert_queue_capacity, 1);
+    }
 
-            if (bIsStreamOpen) {
-                m_objStreamPtr->Close();
-            }
+    // 记录当前采集配置本次会话的统计，切换配置或关闭相机前调用
+    void saveProfileStats() {
+        if (!m_bIsOpen) return;
 
-            if (bIsDeviceOpen) {
-                m_objDevicePtr->Close();
+        m_profile_stats[(int) m_profile.profile] = m_metrics.snapshot();
+    }
+
+    // 运行在后端采集线程中，全程无锁：从帧池取空闲帧，拷贝后经三缓冲发布；需要格式转换时交给转换线程
+    void onFrameCaptured(const RawFrame &raw_frame) {
+        uint64_t callback_ns = FrameMetrics::now();
+        m_metrics.recordReceived(raw_frame.frame_id);
+
+        if (raw_frame.size < m_raw_size) return;
+
+        if (m_converter.isRunning()) {
+            FrameRef raw = m_raw_pool.acquire();
+            if (!raw || raw->data.size() != m_raw_size) {
+                m_metrics.recordPoolDropped();
+                return;
             }
 
+            std::memcpy(raw->data.data(), raw_frame.data, m_raw_size);
+            raw->frame_id = raw_frame.frame_id;
+            raw->timestamp = raw_frame.timestamp;
+            raw->timing.reset();
+            raw->timing.callback_ns = callback_ns;
+            raw->timing.copy_done_ns = FrameMetrics::now();
+
+            // 转换模式下丢帧不通知触发匹配，由转换线程按帧号顺序判定丢失
+            if (!m_converter.push(raw)) m_metrics.recordConvertDropped();
             return;
         }
-    }
 
-    void startSnap() {
-        // TODO: Add your control notification handler code here
-        try {
-            try {
-                // 设置 Buffer 处理模式
-                m_objStreamFeatureControlPtr->GetEnumFeature("StreamBufferHandlingMode")->SetValue("OldestFirst");
-            } catch (...) {}
+        FrameRef frame = m_frame_pool.acquire();
+        if (!frame || (int) frame->data.size() != m_buffer_size) {
+            // 帧池耗尽（消费者持有过多帧），丢弃本帧而不是等待
+            m_metrics.recordPoolDropped();
+            m_trigger_matcher.onFrame(raw_frame.frame_id, FrameRef(), callback_ns, m_metrics);
+            return;
+        }
 
-            // 注册回调函数
-            m_objStreamPtr->RegisterCaptureCallback(m_pCaptureEventHandler, this);
+        std::memcpy(frame->data.data(), raw_frame.data, m_buffer_size);
+        publishFrame(frame, raw_frame.frame_id, raw_frame.timestamp, callback_ns);
+    }
 
-            // 开启流层通道
-            m_objStreamPtr->StartGrab();
+    // 运行在转换线程中：每帧只转换一次，所有消费者共享转换结果
+    void onRawFrameConverting(const FrameRef &raw) {
+        FrameRef frame = m_frame_pool.acquire();
+        if (!frame || (int) frame->data.size() != m_buffer_size) {
+            m_metrics.recordPoolDropped();
+            m_trigger_matcher.onFrame(raw->frame_id, FrameRef(), raw->timing.callback_ns, m_metrics);
+            return;
+        }
 
-            // 发送开采命令
-            m_objFeatureControlPtr->GetCommandFeature("AcquisitionStart")->Execute();
+        convertPixelFormat(m_pixel_format, raw->data.data(), m_image_width, m_image_height,
+                           frame->data.data(), m_image_step);
+        m_metrics.recordConverted(FrameMetrics::now() - raw->timing.copy_done_ns);
 
-            m_bIsSnap = true;
-        } catch (CGalaxyException) {
-            std::cout << "Open device galaxy error!" << std::endl;
+        publishFrame(frame, raw->frame_id, raw->timestamp, raw->timing.callback_ns);
+    }
 
-            return;
-        } catch (std::exception) {
-            std::cout << "Open device std error!" << std::endl;
+    /**
+     * @brief 参数被其它途径修改后，使 applyParameters() 不再跳过这些参数；不带参数时清空全部记录
+     */
+    void forgetParameters(std::initializer_list<const char *> names = {}) {
+        std::lock_guard<std::mutex> locker(m_parameter_mutex);
 
+        if (names.size() == 0) {
+            m_known_parameters.clear();
             return;
         }
-    }
 
-    void stopSnap() {
-        // TODO: Add your control notification handler code here
-        try {
-            // 发送停采命令
-            m_objFeatureControlPtr->GetCommandFeature("AcquisitionStop")->Execute();
+        for (const char *name : names) {
+            m_known_parameters.remove(name);
+        }
+    }
 
-            // 关闭流层通道
-            m_objStreamPtr->StopGrab();
+    // 在自动曝光线程中调用
+    void onAutoExposureFrame(const FrameRef &frame) {
+        if (!m_auto_exposure_running || frame->frame_id < m_auto_exposure_skip_until) return;
 
-            // 注销采集回调
-            m_objStreamPtr->UnregisterCaptureCallback();
+        const AutoExposureSettings &settings = m_auto_exposure.settings();
+        AutoExposure::State previous = m_auto_exposure.state();
 
-            m_bIsSnap = false;
-        } catch (CGalaxyException) {
-            std::cout << "Open device galaxy error!" << std::endl;
+        // 帧统计未开启或测光区域不同时，在本线程中按自动曝光的设置统计
+        FrameStatistics metering;
+        const FrameStatistics *stats = &frame->statistics;
+        if (!stats->valid || stats->roi != settings.roi || stats->subsample != std::max(settings.subsample, 1)) {
+            computeFrameStatistics(frame.mat(), settings.roi, settings.subsample,
+                                   pixelFormatOutputMaxValue(m_pixel_format), metering);
+            stats = &metering;
+        }
+        AutoExposure::State state = m_auto_exposure.update(*stats);
 
-            return;
-        } catch (std::exception) {
-            std::cout << "Open device std error!" << std::endl;
+        if (state == AutoExposure::State::Adjusting) {
+            forgetParameters({"ExposureTime", "Gain"});
+            try {
+                m_backend->setFloatFeature("ExposureTime", m_auto_exposure.exposureUs());
+                m_backend->setFloatFeature("Gain", m_auto_exposure.gainDb());
+            } catch (...) {
+                std::cout << "Set auto exposure error!" << std::endl;
+                m_auto_exposure_running = false;
+                emit signalAutoExposureConverged(false, getExposureTimeUs(), getExposureGainDB());
+                return;
+            }
 
+            // 写入时已开始曝光的帧仍使用旧设置
+            m_auto_exposure_skip_until = frame->frame_id + 1 + (uint64_t) std::max(settings.settle_frames, 0);
             return;
         }
+
+        if (state == previous) return;
+
+        // 不能在本线程中 stop() 自身，只停止送帧，线程由下次启动或 stopAutoExposure() 回收
+        if (!settings.continuous) m_auto_exposure_running = false;
+
+        emit signalAutoExposureConverged(state == AutoExposure::State::Converged,
+                                         m_auto_exposure.exposureUs(), m_auto_exposure.gainDb());
+        emit signalAutoExposureTimeUs(m_auto_exposure.exposureUs());
     }
 
-    void closeDevice() {
-        // TODO: Add your control notification handler code here
-        try {
-            // 判断是否已停止采集
-            if (m_bIsSnap) {
-                // 发送停采命令
-                m_objFeatureControlPtr->GetCommandFeature("AcquisitionStop")->Execute();
+    // 共享内存对象名只能包含一个 '/'
+    std::string defaultSharedMemoryName() {
+        std::string name = "/camera_" + m_backend->serialNumber();
+        std::replace_if(name.begin() + 1, name.end(), [](char c) {
+            return !std::isalnum((unsigned char) c) && c != '_' && c != '-';
+        }, '_');
+
+        return name;
+    }
 
-                // 关闭流层采集
-                m_objStreamPtr->StopGrab();
+    std::string flatFieldPath(const std::string &directory) {
+        std::string path = directory;
+        if (!path.empty() && path.back() != '/' && path.back() != '\\') path += '/';
 
-                // 注销采集回调
-                m_objStreamPtr->UnregisterCaptureCallback();
+        return path + "flat_field_" + m_backend->serialNumber() + ".ffc";
+    }
+
+    // 暂停校正，采集 count 帧的均值
+    cv::Mat grabCalibrationReference(int count, int timeout_ms) {
+        bool enabled = m_flat_field_enabled.exchange(false);
+
+        FrameRef frame = grabAccumulated(count, FrameAccumulator::Method::Mean, timeout_ms);
+
+        m_flat_field_enabled = enabled;
+
+        return frame ? frame.mat().clone() : cv::Mat();
+    }
+
+    // 只在一个线程中调用：直通格式为采集线程，需要转换时为转换线程
+    void publishFrame(const FrameRef &frame, uint64_t frame_id, uint64_t timestamp, uint64_t callback_ns) {
+        frame->width = m_image_width;
+        frame->height = m_image_height;
+        frame->step = m_image_step;
+        frame->cv_type = m_image_cv_type;
+        frame->qimage_format = m_image_qformat;
+        frame->frame_id = frame_id;
+        frame->timestamp = timestamp;
+        frame->sequence = ++m_publish_sequence;
+        frame->timing.reset();
+        frame->timing.callback_ns = callback_ns;
+        frame->timing.copy_done_ns = FrameMetrics::now();
+
+        if (m_flat_field_enabled) {
+            std::shared_ptr<const FlatFieldCorrection> correction;
+            {
+                std::lock_guard<std::mutex> locker(m_flat_field_mutex);
+                correction = m_flat_field;
             }
-        } catch (CGalaxyException) {
-            // do noting
+            cv::Mat image = frame.mat();
+            if (correction) correction->apply(image);
         }
 
-        try {
-            // 关闭流对象
-            m_objStreamPtr->Close();
-        } catch (CGalaxyException) {
-            // do noting
+        if (m_statistics_enabled) {
+            cv::Rect roi;
+            int subsample;
+            {
+                std::lock_guard<std::mutex> locker(m_statistics_mutex);
+                roi = m_statistics_roi;
+                subsample = m_statistics_subsample;
+            }
+            computeFrameStatistics(frame.mat(), roi, subsample, pixelFormatOutputMaxValue(m_pixel_format),
+                                   frame->statistics);
+        } else {
+            frame->statistics.valid = false;
         }
 
-        try {
-            // 关闭设备
-            m_objDevicePtr->Close();
-        } catch (CGalaxyException) {
-            //do noting
+        m_metrics.recordPublished(frame->timing);
+
+        m_frame_buffer.writeBuffer() = frame;
+        m_frame_buffer.publish();
+
+        if (m_recorder.isRecording()) m_recorder.push(frame);
+
+        FramePipeline *pipeline = m_pipeline.load(std::memory_order_acquire);
+        if (pipeline) pipeline->tryPush(frame);
+
+        // 以下消费者可能正由其它线程重新启动；FrameWorker::stop() 会等待正在进行的 push() 返回，
+        // 因此这里先检查标志再 push() 不会与 start() 重置队列竞争
+        if (m_focus_engine.isRunning()) m_focus_engine.push(frame);
+
+        if (m_accumulator.isRunning()) m_accumulator.push(frame);
+
+        if (m_shared_memory_running && !m_shared_memory_worker.push(frame) && m_shared_memory_worker.isRunning()) {
+            m_shared_memory_dropped.fetch_add(1, std::memory_order_relaxed);
         }
 
-        m_bIsOpen = false;
-    }
+        if (m_auto_exposure_running) m_auto_exposure_worker.push(frame);
 
-    void cameraInit() {
-        try {
-            // 初始化库
-            IGXFactory::GetInstance().Init();
+        m_trigger_matcher.onFrame(frame->frame_id, frame, callback_ns, m_metrics);
 
-            m_pCaptureEventHandler = new CSampleCaptureEventHandler();
-        } catch (...) {}
+        emit signalUpdateFrame(frame);
+
+        // 没有连接时不构造 QImage，新代码应使用 signalUpdateFrame()
+        if (isSignalConnected(m_update_image_signal)) emit signalUpdateImage(frame.toQImage());
     }
 
 private:
-    CGXDevicePointer            m_objDevicePtr;                // 设备句柄
-    CGXFeatureControlPointer    m_objFeatureControlPtr;        // 设备控制器对象
-    CGXStreamPointer            m_objStreamPtr;                // 流对象
-    CGXFeatureControlPointer    m_objStreamFeatureControlPtr;  // 流层控制器对象
-    CSampleCaptureEventHandler *m_pCaptureEventHandler;        // 采集回调对象
+    std::unique_ptr<ICameraBackend> m_backend;  // 相机后端
 
     bool m_bIsOpen;
     bool m_bIsSnap;
+    bool m_bIsTriggerMode;
 
-    std::mutex m_image_mutex;
-    CImageDataPointer m_image_data_pointer;
-    std::vector<uint8_t> m_pBuffer;
+    std::mutex m_read_mutex;                 // 仅用于读端之间的串行化
+    FramePool m_frame_pool;                  // 预分配帧池
+    TripleBuffer<FrameRef> m_frame_buffer;   // 采集回调与读端之间的无锁三缓冲
+    bool m_has_image;
     int m_image_height;
     int m_image_width;
-    int m_buffer_size;
+    int m_buffer_size;                       // 输出帧字节数
+    int m_image_step;                        // 输出帧每行字节数
+    int m_image_cv_type;
+    QImage::Format m_image_qformat;
+    PixelFormat m_pixel_format;              // 相机当前像素格式
+    PixelFormat m_requested_pixel_format;    // Unknown 表示沿用相机当前格式
+    size_t m_raw_size;                       // 原始帧字节数
+    size_t m_frame_pool_size;                // 0 表示按内存预算自动计算
+    uint64_t m_publish_sequence;             // 仅发布线程访问
+
+    std::mutex m_flat_field_mutex;
+    std::shared_ptr<const FlatFieldCorrection> m_flat_field;  // 替换整个对象，发布线程持有旧对象时不受影响
+    std::atomic<bool> m_flat_field_enabled;
+    cv::Mat m_flat_field_dark;               // 最近一次采集的暗场参考帧
+
+    std::mutex m_statistics_mutex;           // 保护统计区域与采样间隔
+    std::atomic<bool> m_statistics_enabled;
+    cv::Rect m_statistics_roi;
+    int m_statistics_subsample;
+
+    FramePool m_raw_pool;                    // 待转换的原始帧
+    FrameConverter m_converter;              // 像素格式转换线程
+
+    FrameMetrics m_metrics;                  // 延迟与丢帧统计
+    AcquisitionProfileSettings m_profile;    // 当前采集配置
+    FrameMetrics::Snapshot m_profile_stats[kAcquisitionProfileCount];  // 各配置最近一次使用时的统计
+    QTimer m_metrics_log_timer;
+    QMetaMethod m_update_image_signal;
+
+    FrameRecorder m_recorder;                // 异步录制
+    ImageExporter m_exporter;                // 后台图像导出
+    std::atomic<FramePipeline *> m_pipeline; // 帧处理流水线，由调用方管理
+
+    TriggerMatcher m_trigger_matcher;        // 软触发与帧的匹配
+
+    std::mutex m_parameter_mutex;
+    CameraParameterSet m_known_parameters;   // 已知的相机参数当前值，用于跳过未变化的写入
+    AutoExposure m_auto_exposure;            // 仅自动曝光线程访问
+    FrameWorker m_auto_exposure_worker;      // 自动曝光线程
+    std::atomic<bool> m_auto_exposure_running;
+    uint64_t m_auto_exposure_skip_until;     // 仅自动曝光线程访问
+
+    SharedFrameRingPublisher m_shared_ring;  // 共享内存帧环形缓冲区
+    FrameWorker m_shared_memory_worker;      // 共享内存写入线程，先于环形缓冲区析构
+    std::atomic<bool> m_shared_memory_running;
+    std::atomic<uint64_t> m_shared_memory_dropped;
+
+    FrameAccumulator m_accumulator;          // 多帧累加线程
+    FocusEngine m_focus_engine;              // 清晰度评价线程，最先析构
 };
 
 
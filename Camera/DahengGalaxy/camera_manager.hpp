@@ -0,0 +1,234 @@
+#ifndef CAMERA_MANAGER_HPP
+#define CAMERA_MANAGER_HPP
+
+#include <QObject>
+
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "camera_controller.hpp"
+
+
+/**
+ * @brief 多相机管理：按序列号枚举设备，每台设备一个独立的 CameraController
+ *
+ * 每个控制器拥有各自的帧池、三缓冲与采集回调线程，相机之间不共享任何锁。
+ */
+class CameraManager : public QObject {
+    Q_OBJECT
+
+public:
+    using BackendFactory = std::function<std::unique_ptr<ICameraBackend>(const std::string &serial_number)>;
+
+    explicit CameraManager(QObject *parent = nullptr)
+            : QObject(parent) {
+        m_backend_factory = [](const std::string &serial_number) -> std::unique_ptr<ICameraBackend> {
+#ifdef NO_GALAXY_CAMERA
+            auto backend = std::unique_ptr<SyntheticCameraBackend>(new SyntheticCameraBackend());
+            backend->setSerialNumber(serial_number);
+            return backend;
+#else
+            return std::unique_ptr<ICameraBackend>(new GalaxyCameraBackend(serial_number));
+#endif
+        };
+    }
+
+    ~CameraManager() {
+        closeAll();
+    }
+
+    static CameraManager &getInstance() {
+        static CameraManager instance;  // 局部静态变量，注意生命周期
+        return instance;
+    }
+
+    /**
+     * @brief 替换后端工厂（如模拟后端），只影响之后添加的相机
+     */
+    void setBackendFactory(BackendFactory factory) {
+        m_backend_factory = std::move(factory);
+    }
+
+    /**
+     * @brief 枚举当前连接的设备序列号
+     */
+    std::vector<std::string> enumerateDevices() {
+#ifdef NO_GALAXY_CAMERA
+        return {};
+#else
+        return GalaxyCameraBackend::enumerateDevices();
+#endif
+    }
+
+    /**
+     * @brief 为每台已连接的设备添加一个控制器
+     * @return 新添加的相机个数
+     */
+    size_t addAllDevices() {
+        size_t count = 0;
+        for (const auto &serial_number : enumerateDevices()) {
+            if (addCamera(serial_number)) count++;
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief 按序列号添加相机（不打开）；已存在时返回已有的控制器
+     */
+    CameraController *addCamera(const std::string &serial_number) {
+        return addCamera(serial_number, m_backend_factory(serial_number));
+    }
+
+    CameraController *addCamera(const std::string &serial_number, std::unique_ptr<ICameraBackend> backend) {
+        auto it = m_cameras.find(serial_number);
+        if (it != m_cameras.end()) return it->second.get();
+        if (!backend) return nullptr;
+
+        auto camera = std::unique_ptr<CameraController>(new CameraController(std::move(backend)));
+        CameraController *ptr = camera.get();
+        m_cameras[serial_number] = std::move(camera);
+        m_serial_numbers.push_back(serial_number);
+
+        return ptr;
+    }
+
+    void removeCamera(const std::string &serial_number) {
+        auto it = m_cameras.find(serial_number);
+        if (it == m_cameras.end()) return;
+
+        it->second->closeCamera();
+        m_cameras.erase(it);
+        m_serial_numbers.erase(std::find(m_serial_numbers.begin(), m_serial_numbers.end(), serial_number));
+    }
+
+    CameraController *getCamera(const std::string &serial_number) {
+        auto it = m_cameras.find(serial_number);
+        return it != m_cameras.end() ? it->second.get() : nullptr;
+    }
+
+    CameraController *getCamera(size_t index) {
+        return index < m_serial_numbers.size() ? getCamera(m_serial_numbers[index]) : nullptr;
+    }
+
+    size_t cameraCount() const {
+        return m_serial_numbers.size();
+    }
+
+    /**
+     * @brief 按添加顺序返回序列号
+     */
+    const std::vector<std::string> &serialNumbers() const {
+        return m_serial_numbers;
+    }
+
+    /**
+     * @brief 并行打开并开始采集所有相机（设备打开较慢，逐台打开耗时会随相机数线性增长）
+     *
+     * 设备只枚举一次，之后各相机并行打开，不会在多个线程中同时枚举。已打开但暂停采集的相机
+     * （如 stopAll() 之后）只恢复采集，不重复打开设备。
+     *
+     * @return 成功打开的相机个数
+     */
+    size_t openAll() {
+        std::vector<CameraController *> closed;
+        for (const auto &serial_number : m_serial_numbers) {
+            CameraController *camera = getCamera(serial_number);
+            if (camera->isDeviceOpen()) {
+                camera->startGrab();
+            } else {
+                closed.push_back(camera);
+            }
+        }
+        if (!closed.empty()) {
+            enumerateDevices();
+
+            std::vector<std::thread> threads;
+            for (CameraController *camera : closed) {
+                threads.emplace_back([camera]() {
+                    camera->openCamera();
+                });
+            }
+            for (auto &thread : threads) {
+                thread.join();
+            }
+        }
+
+        size_t count = 0;
+        for (const auto &serial_number : m_serial_numbers) {
+            if (getCamera(serial_number)->isCameraOpen()) {
+                count++;
+            } else {
+                std::cout << "Camera " << serial_number << " open failed!" << std::endl;
+            }
+        }
+
+        return count;
+    }
+
+    void closeAll() {
+        for (const auto &serial_number : m_serial_numbers) {
+            getCamera(serial_number)->closeCamera();
+        }
+    }
+
+    /**
+     * @brief 同时恢复所有相机的采集
+     */
+    void startAll() {
+        for (const auto &serial_number : m_serial_numbers) {
+            getCamera(serial_number)->startGrab();
+        }
+    }
+
+    /**
+     * @brief 同时暂停所有相机的采集（不关闭设备）
+     */
+    void stopAll() {
+        for (const auto &serial_number : m_serial_numbers) {
+            getCamera(serial_number)->stopGrab();
+        }
+    }
+
+    /**
+     * @brief 以下对所有相机的操作跳过未能打开的相机
+     */
+    void enterTriggerModeAll() {
+        for (const auto &serial_number : m_serial_numbers) {
+            CameraController *camera = getCamera(serial_number);
+            if (camera->isCameraOpen()) camera->enterTriggerMode();
+        }
+    }
+
+    void exitTriggerModeAll() {
+        for (const auto &serial_number : m_serial_numbers) {
+            CameraController *camera = getCamera(serial_number);
+            if (camera->isCameraOpen()) camera->exitTriggerMode();
+        }
+    }
+
+    void softwareTriggerAll() {
+        for (const auto &serial_number : m_serial_numbers) {
+            CameraController *camera = getCamera(serial_number);
+            if (camera->isCameraOpen()) camera->slotSoftwareTrigger();
+        }
+    }
+
+private:
+    CameraManager(const CameraManager &) = delete;
+    CameraManager &operator=(const CameraManager &) = delete;
+
+private:
+    BackendFactory m_backend_factory;
+    std::map<std::string, std::unique_ptr<CameraController>> m_cameras;
+    std::vector<std::string> m_serial_numbers;
+};
+
+
+#endif // CAMERA_MANAGER_HPP
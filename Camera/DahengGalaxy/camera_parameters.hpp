@@ -0,0 +1,176 @@
+#ifndef CAMERA_PARAMETERS_HPP
+#define CAMERA_PARAMETERS_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief 一组相机参数（特征名与取值），用于一次性批量写入或读回
+ *
+ * 按加入顺序写入，同名参数只保留最后一次设置的值（位置不变）。存在依赖的参数应按依赖顺序加入，
+ * 如先设置 ExposureAuto 为 Off 再设置 ExposureTime。像素格式与 ROI 会改变帧尺寸，
+ * 应通过 CameraController::setPixelFormat() / setGeometry() 修改，不放入参数组。
+ */
+class CameraParameterSet {
+public:
+    enum class Type {
+        Int,
+        Float,
+        Enum,
+        Command,
+    };
+
+    struct Entry {
+        std::string name;
+        Type type = Type::Float;
+        int64_t int_value = 0;
+        double float_value = 0;
+        std::string enum_value;
+
+        bool sameValue(const Entry &other) const {
+            if (type != other.type) return false;
+
+            switch (type) {
+                case Type::Int: return int_value == other.int_value;
+                case Type::Float: return std::fabs(float_value - other.float_value) <= 1e-9 * std::fabs(float_value);
+                case Type::Enum: return enum_value == other.enum_value;
+                case Type::Command: return false;  // 命令每次都要执行
+            }
+
+            return false;
+        }
+    };
+
+    CameraParameterSet &setInt(const std::string &name, int64_t value) {
+        entry(name, Type::Int).int_value = value;
+        return *this;
+    }
+
+    CameraParameterSet &setFloat(const std::string &name, double value) {
+        entry(name, Type::Float).float_value = value;
+        return *this;
+    }
+
+    CameraParameterSet &setEnum(const std::string &name, const std::string &value) {
+        entry(name, Type::Enum).enum_value = value;
+        return *this;
+    }
+
+    CameraParameterSet &execute(const std::string &name) {
+        entry(name, Type::Command);
+        return *this;
+    }
+
+    CameraParameterSet &set(const Entry &e) {
+        entry(e.name, e.type) = e;
+        return *this;
+    }
+
+    /**
+     * @brief 用另一组参数覆盖同名参数，并追加本组没有的参数
+     */
+    CameraParameterSet &merge(const CameraParameterSet &other) {
+        for (const Entry &e : other.m_entries) {
+            set(e);
+        }
+        return *this;
+    }
+
+    void remove(const std::string &name) {
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->name == name) {
+                m_entries.erase(it);
+                return;
+            }
+        }
+    }
+
+    void clear() {
+        m_entries.clear();
+    }
+
+    const Entry *find(const std::string &name) const {
+        for (const Entry &e : m_entries) {
+            if (e.name == name) return &e;
+        }
+        return nullptr;
+    }
+
+    const std::vector<Entry> &entries() const {
+        return m_entries;
+    }
+
+    bool empty() const {
+        return m_entries.empty();
+    }
+
+    size_t size() const {
+        return m_entries.size();
+    }
+
+    /**
+     * @brief 每行一个 "名称 = 取值"，用于日志与配方比对
+     */
+    std::string toString() const {
+        std::ostringstream ss;
+
+        for (const Entry &e : m_entries) {
+            ss << e.name << " = ";
+            switch (e.type) {
+                case Type::Int: ss << e.int_value; break;
+                case Type::Float: ss << e.float_value; break;
+                case Type::Enum: ss << e.enum_value; break;
+                case Type::Command: ss << "(execute)"; break;
+            }
+            ss << "\n";
+        }
+
+        return ss.str();
+    }
+
+    /**
+     * @brief 快照默认读取的参数：曝光、增益、触发与帧率等不影响帧尺寸的常用设置
+     */
+    static CameraParameterSet standardParameters() {
+        CameraParameterSet parameters;
+        parameters.setEnum("ExposureAuto", "");
+        parameters.setFloat("ExposureTime", 0);
+        parameters.setEnum("GainAuto", "");
+        parameters.setFloat("Gain", 0);
+        parameters.setFloat("BlackLevel", 0);
+        parameters.setEnum("TriggerMode", "");
+        parameters.setEnum("TriggerSource", "");
+        parameters.setEnum("TriggerActivation", "");
+        parameters.setFloat("TriggerDelay", 0);
+        parameters.setEnum("AcquisitionFrameRateMode", "");
+        parameters.setFloat("AcquisitionFrameRate", 0);
+
+        return parameters;
+    }
+
+private:
+    Entry &entry(const std::string &name, Type type) {
+        for (Entry &e : m_entries) {
+            if (e.name == name) {
+                e.type = type;
+                return e;
+            }
+        }
+
+        m_entries.emplace_back();
+        m_entries.back().name = name;
+        m_entries.back().type = type;
+
+        return m_entries.back();
+    }
+
+private:
+    std::vector<Entry> m_entries;
+};
+
+
+#endif // CAMERA_PARAMETERS_HPP
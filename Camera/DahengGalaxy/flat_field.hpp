@@ -0,0 +1,280 @@
+#ifndef FLAT_FIELD_HPP
+#define FLAT_FIELD_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+
+/**
+ * 平场校正文件格式（小端）
+ *
+ *   FlatFieldHeader
+ *   uint16_t offset[height][width * channels]    暗场（与帧同单位）
+ *   uint16_t gain[height][width * channels]      增益，定点数，1.0 = 1 << gain_shift
+ */
+
+static constexpr char kFlatFieldMagic[8] = {'F', 'L', 'A', 'T', 'F', 'D', '0', '1'};
+static constexpr uint32_t kFlatFieldVersion = 1;
+
+struct FlatFieldHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    char serial_number[64];
+    int32_t width;
+    int32_t height;
+    int32_t cv_type;
+    int32_t gain_shift;
+};
+
+static_assert(sizeof(FlatFieldHeader) == 96, "unexpected FlatFieldHeader layout");
+
+
+/**
+ * @brief 暗场与平场校正：out = (in - offset) * gain
+ *
+ * 偏移与增益图由暗场、平场参考帧（通常为多帧均值，见 FrameAccumulator）预先算好，
+ * 每帧只做一次减法、一次 16 位定点乘法与移位，无分支，按行并行，编译器可自动向量化。
+ * 增益按平场的通道均值归一化，校正后平场的平均亮度不变；增益上限为 4。
+ */
+class FlatFieldCorrection {
+public:
+    static constexpr int kGainShift = 14;
+    static constexpr uint32_t kGainOne = 1u << kGainShift;
+
+    /**
+     * @param dark - 暗场参考帧，为空时偏移为 0
+     * @param flat - 平场参考帧（均匀照明，未饱和），类型决定可校正的帧类型
+     * @param serial_number - 相机序列号，保存与加载时用于核对
+     * @return 参考帧为空或尺寸类型不一致时返回 false
+     */
+    bool create(const cv::Mat &dark, const cv::Mat &flat, const std::string &serial_number) {
+        if (flat.empty()) return false;
+        if (flat.depth() != CV_8U && flat.depth() != CV_16U) return false;
+        if (!dark.empty() && (dark.rows != flat.rows || dark.cols != flat.cols || dark.type() != flat.type())) {
+            return false;
+        }
+
+        m_width = flat.cols;
+        m_height = flat.rows;
+        m_cv_type = flat.type();
+        m_serial_number = serial_number;
+        m_offset.create(m_height, m_width, CV_MAKETYPE(CV_16U, flat.channels()));
+        m_gain.create(m_height, m_width, CV_MAKETYPE(CV_16U, flat.channels()));
+
+        cv::Mat dark_16u, flat_16u;
+        if (dark.empty()) {
+            dark_16u = cv::Mat::zeros(m_height, m_width, m_offset.type());
+        } else {
+            dark.convertTo(dark_16u, CV_16U);
+        }
+        flat.convertTo(flat_16u, CV_16U);
+
+        // 各通道（去暗场后）平场的均值作为校正目标
+        int channels = flat.channels();
+        int elements = m_width * channels;
+        std::vector<double> target(channels, 0);
+        for (int y = 0; y < m_height; y++) {
+            const uint16_t *d = dark_16u.ptr<uint16_t>(y);
+            const uint16_t *f = flat_16u.ptr<uint16_t>(y);
+            for (int x = 0; x < elements; x++) {
+                target[x % channels] += std::max((int) f[x] - (int) d[x], 0);
+            }
+        }
+        for (double &t : target) {
+            t /= (double) m_width * (double) m_height;
+        }
+
+        uint32_t max_gain = 4 * kGainOne - 1;
+        for (int y = 0; y < m_height; y++) {
+            const uint16_t *d = dark_16u.ptr<uint16_t>(y);
+            const uint16_t *f = flat_16u.ptr<uint16_t>(y);
+            uint16_t *offset = m_offset.ptr<uint16_t>(y);
+            uint16_t *gain = m_gain.ptr<uint16_t>(y);
+
+            for (int x = 0; x < elements; x++) {
+                int signal = (int) f[x] - (int) d[x];
+                double g = signal > 0 ? target[x % channels] / signal : 1.0;  // 坏点保持原值
+                offset[x] = d[x];
+                gain[x] = (uint16_t) std::min<uint32_t>((uint32_t) std::lround(g * kGainOne), max_gain);
+            }
+        }
+
+        return true;
+    }
+
+    bool isValid() const {
+        return !m_gain.empty();
+    }
+
+    /**
+     * @brief 帧尺寸与类型是否与校正图一致
+     */
+    bool matches(int width, int height, int cv_type) const {
+        return isValid() && width == m_width && height == m_height && cv_type == m_cv_type;
+    }
+
+    /**
+     * @brief 原位校正一帧
+     * @return 尺寸或类型与校正图不一致时不修改图像并返回 false
+     */
+    bool apply(cv::Mat &image) const {
+        if (!matches(image.cols, image.rows, image.type())) return false;
+
+        if (image.depth() == CV_16U) {
+            applyRows<uint16_t>(image);
+        } else {
+            applyRows<uint8_t>(image);
+        }
+
+        return true;
+    }
+
+    const std::string &serialNumber() const {
+        return m_serial_number;
+    }
+
+    int width() const {
+        return m_width;
+    }
+
+    int height() const {
+        return m_height;
+    }
+
+    int cvType() const {
+        return m_cv_type;
+    }
+
+    const cv::Mat &offsetMap() const {
+        return m_offset;
+    }
+
+    const cv::Mat &gainMap() const {
+        return m_gain;
+    }
+
+    bool save(const std::string &path) const {
+        if (!isValid()) return false;
+
+        FlatFieldHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, kFlatFieldMagic, sizeof(header.magic));
+        header.version = kFlatFieldVersion;
+        header.header_size = sizeof(FlatFieldHeader);
+        std::strncpy(header.serial_number, m_serial_number.c_str(), sizeof(header.serial_number) - 1);
+        header.width = m_width;
+        header.height = m_height;
+        header.cv_type = m_cv_type;
+        header.gain_shift = kGainShift;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cout << "Flat field file open error: " << path << std::endl;
+            return false;
+        }
+
+        file.write((const char *) &header, sizeof(header));
+        writeMap(file, m_offset);
+        writeMap(file, m_gain);
+
+        return file.good();
+    }
+
+    /**
+     * @param serial_number - 非空时要求与文件中的序列号一致
+     */
+    bool load(const std::string &path, const std::string &serial_number = std::string()) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+
+        FlatFieldHeader header;
+        file.read((char *) &header, sizeof(header));
+        if (!file || std::memcmp(header.magic, kFlatFieldMagic, sizeof(header.magic)) != 0 ||
+            header.version != kFlatFieldVersion || header.gain_shift != kGainShift ||
+            header.width <= 0 || header.height <= 0) {
+            std::cout << "Flat field file format error: " << path << std::endl;
+            return false;
+        }
+
+        header.serial_number[sizeof(header.serial_number) - 1] = '\0';
+        if (!serial_number.empty() && serial_number != header.serial_number) {
+            std::cout << "Flat field file belongs to camera " << header.serial_number << ": " << path << std::endl;
+            return false;
+        }
+
+        int map_type = CV_MAKETYPE(CV_16U, CV_MAT_CN(header.cv_type));
+        cv::Mat offset(header.height, header.width, map_type);
+        cv::Mat gain(header.height, header.width, map_type);
+        if (!readMap(file, offset) || !readMap(file, gain)) {
+            std::cout << "Flat field file truncated: " << path << std::endl;
+            return false;
+        }
+
+        m_width = header.width;
+        m_height = header.height;
+        m_cv_type = header.cv_type;
+        m_serial_number = header.serial_number;
+        m_offset = offset;
+        m_gain = gain;
+
+        return true;
+    }
+
+private:
+    template<typename T>
+    void applyRows(cv::Mat &image) const {
+        int elements = m_width * CV_MAT_CN(m_cv_type);
+        const int max_value = (int) std::numeric_limits<T>::max();
+
+        cv::parallel_for_(cv::Range(0, m_height), [&](const cv::Range &range) {
+            for (int y = range.start; y < range.end; y++) {
+                T *p = image.ptr<T>(y);
+                const uint16_t *offset = m_offset.ptr<uint16_t>(y);
+                const uint16_t *gain = m_gain.ptr<uint16_t>(y);
+
+                // 16 位帧 65535 * 65535 仍在 uint32 范围内
+                for (int x = 0; x < elements; x++) {
+                    int signal = std::max((int) p[x] - (int) offset[x], 0);
+                    uint32_t v = ((uint32_t) signal * gain[x] + (kGainOne >> 1)) >> kGainShift;
+                    p[x] = (T) std::min((int) v, max_value);
+                }
+            }
+        });
+    }
+
+    static void writeMap(std::ofstream &file, const cv::Mat &map) {
+        size_t row_size = (size_t) map.cols * map.elemSize();
+        for (int y = 0; y < map.rows; y++) {
+            file.write((const char *) map.ptr<uint16_t>(y), (std::streamsize) row_size);
+        }
+    }
+
+    static bool readMap(std::ifstream &file, cv::Mat &map) {
+        size_t row_size = (size_t) map.cols * map.elemSize();
+        for (int y = 0; y < map.rows; y++) {
+            file.read((char *) map.ptr<uint16_t>(y), (std::streamsize) row_size);
+        }
+        return file.good();
+    }
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    int m_cv_type = 0;
+    std::string m_serial_number;
+    cv::Mat m_offset;                        // CV_16U，暗场
+    cv::Mat m_gain;                          // CV_16U，定点增益
+};
+
+
+#endif // FLAT_FIELD_HPP
@@ -0,0 +1,241 @@
+#ifndef FOCUS_METRIC_HPP
+#define FOCUS_METRIC_HPP
+
+#include <QMetaType>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+#include "opencv2/opencv.hpp"
+#include "frame_metrics.hpp"
+#include "frame_pool.hpp"
+#include "frame_worker.hpp"
+
+
+enum class FocusMeasure {
+    VarianceOfLaplacian,     // 拉普拉斯响应的方差
+    Tenengrad,               // Sobel 梯度平方的均值
+    NormalizedGrayVariance,  // 灰度方差 / 灰度均值，对亮度变化不敏感
+};
+
+
+/**
+ * @brief 单帧的清晰度评价结果，score 越大越清晰
+ *
+ * 不同评价方法、像素格式或 ROI 下的 score 不可相互比较。
+ */
+struct FocusResult {
+    uint64_t frame_id = 0;       // SDK 帧号
+    uint64_t sequence = 0;       // 发布序号
+    uint64_t timestamp = 0;      // SDK 时间戳
+    FocusMeasure measure = FocusMeasure::VarianceOfLaplacian;
+    double score = 0;
+    double compute_us = 0;       // 计算耗时
+};
+
+Q_DECLARE_METATYPE(FocusResult)
+
+
+/**
+ * @brief 清晰度评价
+ *
+ * 计算全部交给 OpenCV 的滤波与统计函数（内部已向量化）。彩色帧只取绿色通道，
+ * 可通过 ROI 与降采样进一步降低开销，保证全帧率运行。
+ */
+class FocusEngine {
+public:
+    using ResultCallback = std::function<void(const FocusResult &result)>;
+
+    FocusEngine()
+            : m_enabled(false),
+              m_measure(FocusMeasure::VarianceOfLaplacian),
+              m_subsample(1),
+              m_dropped(0) {}
+
+    ~FocusEngine() {
+        stop();
+    }
+
+    FocusEngine(const FocusEngine &) = delete;
+    FocusEngine &operator=(const FocusEngine &) = delete;
+
+    /**
+     * @brief 计算一帧（或其中一块区域）的清晰度，可在任意线程中直接调用
+     * @param roi - 评价区域，为空时使用整帧，超出图像的部分被裁掉
+     * @param subsample - 降采样倍数，1 表示不降采样
+     */
+    static double measure(const cv::Mat &image, FocusMeasure measure, const cv::Rect &roi = cv::Rect(),
+                          int subsample = 1) {
+        if (image.empty()) return 0;
+
+        cv::Mat region = image;
+        if (roi.area() > 0) {
+            cv::Rect clipped = roi & cv::Rect(0, 0, image.cols, image.rows);
+            if (clipped.area() <= 0) return 0;
+            region = image(clipped);
+        }
+
+        cv::Mat gray;
+        if (region.channels() == 3) {
+            cv::extractChannel(region, gray, 1);
+        } else {
+            gray = region;
+        }
+
+        if (subsample > 1) {
+            cv::Mat small;
+            cv::resize(gray, small, cv::Size(std::max(gray.cols / subsample, 3), std::max(gray.rows / subsample, 3)),
+                       0, 0, cv::INTER_NEAREST);
+            gray = small;
+        }
+
+        switch (measure) {
+            case FocusMeasure::VarianceOfLaplacian: {
+                cv::Mat laplacian;
+                cv::Laplacian(gray, laplacian, CV_32F);
+
+                cv::Scalar mean, stddev;
+                cv::meanStdDev(laplacian, mean, stddev);
+                return stddev[0] * stddev[0];
+            }
+            case FocusMeasure::Tenengrad: {
+                cv::Mat gx, gy;
+                cv::Sobel(gray, gx, CV_32F, 1, 0, 3);
+                cv::Sobel(gray, gy, CV_32F, 0, 1, 3);
+                cv::multiply(gx, gx, gx);
+                cv::multiply(gy, gy, gy);
+                cv::add(gx, gy, gx);
+                return cv::mean(gx)[0];
+            }
+            case FocusMeasure::NormalizedGrayVariance: {
+                cv::Scalar mean, stddev;
+                cv::meanStdDev(gray, mean, stddev);
+                return mean[0] > 0 ? stddev[0] * stddev[0] / mean[0] : 0;
+            }
+        }
+
+        return 0;
+    }
+
+    static FocusResult measure(const FrameRef &frame, FocusMeasure focus_measure, const cv::Rect &roi = cv::Rect(),
+                               int subsample = 1) {
+        FocusResult result;
+        if (!frame) return result;
+
+        uint64_t begin_ns = FrameMetrics::now();
+        result.frame_id = frame->frame_id;
+        result.sequence = frame->sequence;
+        result.timestamp = frame->timestamp;
+        result.measure = focus_measure;
+        result.score = measure(frame.mat(), focus_measure, roi, subsample);
+        result.compute_us = (double) (FrameMetrics::now() - begin_ns) / 1000.0;
+
+        return result;
+    }
+
+    /**
+     * @brief 启动评价线程，之后通过 push() 送入的帧在该线程中计算并回调
+     */
+    void start(ResultCallback callback) {
+        stop();
+
+        m_callback = std::move(callback);
+        m_dropped = 0;
+        m_worker.start([this](const FrameRef &frame) {
+            onFrame(frame);
+        }, 2);
+        m_enabled = true;
+    }
+
+    void stop() {
+        m_enabled = false;
+        m_worker.stop();
+    }
+
+    bool isRunning() const {
+        return m_enabled;
+    }
+
+    void setMeasure(FocusMeasure focus_measure) {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_measure = focus_measure;
+    }
+
+    /**
+     * @brief 设置评价区域（帧坐标），空区域表示整帧
+     */
+    void setRoi(const cv::Rect &roi) {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_roi = roi;
+    }
+
+    void setSubsample(int subsample) {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_subsample = std::max(subsample, 1);
+    }
+
+    /**
+     * @brief 由帧的发布线程调用，不阻塞；评价线程忙时丢弃并计数
+     */
+    bool push(const FrameRef &frame) {
+        if (!m_enabled || !frame) return false;
+
+        if (!m_worker.push(frame)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        return true;
+    }
+
+    FocusResult latestResult() {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_latest;
+    }
+
+    /**
+     * @brief 评价线程跟不上而未评价的帧数
+     */
+    uint64_t droppedCount() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    void onFrame(const FrameRef &frame) {
+        FocusMeasure focus_measure;
+        cv::Rect roi;
+        int subsample;
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            focus_measure = m_measure;
+            roi = m_roi;
+            subsample = m_subsample;
+        }
+
+        FocusResult result = measure(frame, focus_measure, roi, subsample);
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_latest = result;
+        }
+
+        if (m_callback) m_callback(result);
+    }
+
+private:
+    FrameWorker m_worker;        // 评价线程
+    ResultCallback m_callback;
+    std::atomic<bool> m_enabled;
+
+    std::mutex m_mutex;
+    FocusMeasure m_measure;
+    cv::Rect m_roi;
+    int m_subsample;
+    FocusResult m_latest;
+
+    std::atomic<uint64_t> m_dropped;
+};
+
+
+#endif // FOCUS_METRIC_HPP
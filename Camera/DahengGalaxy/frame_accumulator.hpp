@@ -0,0 +1,300 @@
+#ifndef FRAME_ACCUMULATOR_HPP
+#define FRAME_ACCUMULATOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+#include "frame_pool.hpp"
+#include "frame_worker.hpp"
+
+
+/**
+ * @brief 多帧累加降噪
+ *
+ * 帧到达时即累加到 32 位整数累加器（cv::add，已向量化），N 帧后输出均值帧；中值模式保留 N 帧句柄，
+ * 输出时逐像素求中值。累加在独立线程中进行，不阻塞采集，输入帧零拷贝。
+ *
+ * 输出方式：
+ *   Block   - 每 N 帧输出一帧，之后重新累加；
+ *   Rolling - 攒满 N 帧后每来一帧输出一帧（滑动窗口，均值模式减去移出窗口的帧）。
+ *
+ * 注意：Rolling 与中值模式会持有 N 帧的帧池对象，N 受 start() 的 max_held_frames 限制。
+ */
+class FrameAccumulator {
+public:
+    enum class Method {
+        Mean,
+        Median,
+    };
+
+    enum class Mode {
+        Block,
+        Rolling,
+    };
+
+    struct Settings {
+        int count = 8;               // 每次输出合并的帧数
+        Method method = Method::Mean;
+        Mode mode = Mode::Block;
+    };
+
+    using ResultCallback = std::function<void(const FrameRef &result)>;
+
+    FrameAccumulator()
+            : m_running(false),
+              m_dropped(0),
+              m_result_count(0) {}
+
+    ~FrameAccumulator() {
+        stop();
+    }
+
+    FrameAccumulator(const FrameAccumulator &) = delete;
+    FrameAccumulator &operator=(const FrameAccumulator &) = delete;
+
+    /**
+     * @param callback - 在累加线程中对每一输出帧调用
+     * @param max_held_frames - Rolling 或中值模式下允许持有的最大输入帧数
+     */
+    void start(const Settings &settings, ResultCallback callback, size_t max_held_frames) {
+        stop();
+
+        m_settings = settings;
+        m_settings.count = std::max(m_settings.count, 1);
+        if (m_settings.mode == Mode::Rolling || m_settings.method == Method::Median) {
+            m_settings.count = std::min(m_settings.count, (int) std::max<size_t>(max_held_frames, 1));
+        }
+        // 16 位帧累加 32767 帧以内不会溢出
+        m_settings.count = std::min(m_settings.count, kMaxCount);
+
+        m_callback = std::move(callback);
+        m_dropped = 0;
+        resetAccumulator();
+
+        m_worker.start([this](const FrameRef &frame) {
+            onFrame(frame);
+        }, kQueueCapacity);
+        m_running = true;
+    }
+
+    /**
+     * @brief 停止并释放持有的输入帧
+     */
+    void stop() {
+        m_running = false;
+        m_worker.stop();
+        resetAccumulator();
+    }
+
+    bool isRunning() const {
+        return m_running;
+    }
+
+    const Settings &settings() const {
+        return m_settings;
+    }
+
+    /**
+     * @brief 由帧的发布线程调用，不阻塞；累加线程跟不上时丢弃并计数
+     *
+     * 可与 start() / stop() 并发：累加线程重启期间 push() 返回 false，不计入丢帧。
+     */
+    bool push(const FrameRef &frame) {
+        if (!m_running || !frame) return false;
+
+        if (!m_worker.push(frame)) {
+            if (m_worker.isRunning()) m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        return true;
+    }
+
+    uint64_t droppedCount() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    FrameRef latestResult() {
+        std::lock_guard<std::mutex> locker(m_result_mutex);
+        return m_latest;
+    }
+
+    /**
+     * @brief 等待调用之后产生的下一帧输出
+     * @return 超时返回空句柄
+     */
+    FrameRef waitResult(int timeout_ms) {
+        std::unique_lock<std::mutex> locker(m_result_mutex);
+
+        uint64_t count = m_result_count;
+        bool ready = m_result_cond.wait_for(locker, std::chrono::milliseconds(timeout_ms), [this, count]() {
+            return m_result_count != count;
+        });
+
+        return ready ? m_latest : FrameRef();
+    }
+
+    /**
+     * @brief 逐像素求 N 帧的中值（N 为偶数时取较小的中间值），按行并行
+     */
+    static void median(const std::vector<cv::Mat> &frames, cv::Mat &dst) {
+        if (frames.empty()) return;
+
+        if (frames[0].depth() == CV_16U) {
+            medianOf<uint16_t>(frames, dst);
+        } else {
+            medianOf<uint8_t>(frames, dst);
+        }
+    }
+
+private:
+    static constexpr int kMaxCount = 32767;
+    static constexpr size_t kQueueCapacity = 2;
+    static constexpr size_t kResultPoolSize = 3;
+
+    template<typename T>
+    static void medianOf(const std::vector<cv::Mat> &frames, cv::Mat &dst) {
+        int rows = dst.rows;
+        int elements = dst.cols * dst.channels();
+        size_t n = frames.size();
+
+        cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range &range) {
+            std::vector<const T *> src(n);
+            std::vector<T> values(n);
+
+            for (int y = range.start; y < range.end; y++) {
+                for (size_t i = 0; i < n; i++) {
+                    src[i] = frames[i].ptr<T>(y);
+                }
+                T *out = dst.ptr<T>(y);
+
+                for (int x = 0; x < elements; x++) {
+                    for (size_t i = 0; i < n; i++) {
+                        values[i] = src[i][x];
+                    }
+                    std::nth_element(values.begin(), values.begin() + (n - 1) / 2, values.end());
+                    out[x] = values[(n - 1) / 2];
+                }
+            }
+        });
+    }
+
+    void resetAccumulator() {
+        m_window.clear();
+        m_sum.release();
+        m_block_count = 0;
+        m_width = m_height = m_cv_type = 0;
+    }
+
+    // 在累加线程中调用
+    void onFrame(const FrameRef &frame) {
+        // 尺寸或类型改变（如修改 ROI）时重新开始
+        if (frame->width != m_width || frame->height != m_height || frame->cv_type != m_cv_type) {
+            resetAccumulator();
+            m_width = frame->width;
+            m_height = frame->height;
+            m_cv_type = frame->cv_type;
+            m_result_pool.allocate(kResultPoolSize, (size_t) frame->step * (size_t) frame->height);
+        }
+
+        int n = m_settings.count;
+        bool median = m_settings.method == Method::Median;
+        bool rolling = m_settings.mode == Mode::Rolling;
+
+        if (!median) {
+            if (m_sum.empty()) m_sum = cv::Mat::zeros(m_height, m_width, CV_MAKETYPE(CV_32S, CV_MAT_CN(m_cv_type)));
+            cv::add(m_sum, frame.mat(), m_sum, cv::noArray(), m_sum.type());
+        }
+
+        if (median || rolling) m_window.push_back(frame);
+        if (rolling && (int) m_window.size() > n) {
+            if (!median) cv::subtract(m_sum, m_window.front().mat(), m_sum, cv::noArray(), m_sum.type());
+            m_window.pop_front();
+        }
+        m_block_count++;
+
+        bool ready = rolling ? (int) m_window.size() == n : m_block_count >= n;
+        if (!ready) return;
+
+        FrameRef result = m_result_pool.acquire();
+        if (result) {
+            Frame &out = *result;
+            out.width = frame->width;
+            out.height = frame->height;
+            out.step = frame->step;
+            out.cv_type = frame->cv_type;
+            out.qimage_format = frame->qimage_format;
+            out.frame_id = frame->frame_id;
+            out.timestamp = frame->timestamp;
+            out.sequence = frame->sequence;
+            out.timing.reset();
+            out.timing.callback_ns = frame->timing.callback_ns;
+            out.timing.copy_done_ns = frame->timing.copy_done_ns;
+            out.statistics.valid = false;
+
+            cv::Mat dst = result.mat();
+            if (median) {
+                std::vector<cv::Mat> frames;
+                frames.reserve(m_window.size());
+                for (const FrameRef &f : m_window) {
+                    frames.push_back(f.mat());
+                }
+                FrameAccumulator::median(frames, dst);
+            } else {
+                m_sum.convertTo(dst, m_cv_type, 1.0 / n);
+            }
+        } else {
+            // 消费者仍持有全部输出帧
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (!rolling) {
+            m_window.clear();
+            if (!median) m_sum.setTo(cv::Scalar::all(0));
+            m_block_count = 0;
+        }
+
+        if (!result) return;
+
+        {
+            std::lock_guard<std::mutex> locker(m_result_mutex);
+            m_latest = result;
+            m_result_count++;
+        }
+        m_result_cond.notify_all();
+
+        if (m_callback) m_callback(result);
+    }
+
+private:
+    Settings m_settings;
+    ResultCallback m_callback;
+    FrameWorker m_worker;                    // 累加线程
+    std::atomic<bool> m_running;
+    std::atomic<uint64_t> m_dropped;
+
+    // 以下仅累加线程访问
+    cv::Mat m_sum;                           // 32 位整数累加器
+    std::deque<FrameRef> m_window;           // Rolling 或中值模式下持有的输入帧
+    int m_block_count = 0;
+    int m_width = 0;
+    int m_height = 0;
+    int m_cv_type = 0;
+    FramePool m_result_pool;                 // 输出帧
+
+    std::mutex m_result_mutex;
+    std::condition_variable m_result_cond;
+    FrameRef m_latest;
+    uint64_t m_result_count;
+};
+
+
+#endif // FRAME_ACCUMULATOR_HPP
@@ -0,0 +1,17 @@
+#ifndef FRAME_CONVERTER_HPP
+#define FRAME_CONVERTER_HPP
+
+#include "frame_worker.hpp"
+
+
+/**
+ * @brief 像素格式转换线程
+ *
+ * 采集线程只把原始帧拷贝进帧池后通过 push() 投递（不等待转换），转换（解包、Bayer 插值）
+ * 与发布在独立线程中按顺序执行。队列满时按采集配置丢弃新帧或最旧的帧（见 FrameWorker::OverflowPolicy），由调用方计数。
+ */
+class FrameConverter : public FrameWorker {
+};
+
+
+#endif // FRAME_CONVERTER_HPP
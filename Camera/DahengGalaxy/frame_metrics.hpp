@@ -0,0 +1,330 @@
+#ifndef FRAME_METRICS_HPP
+#define FRAME_METRICS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+
+/**
+ * @brief 无锁延迟直方图，记录一次只需一次原子加法，可在采集回调线程中使用
+ *
+ * 桶按对数划分（每 2 倍 8 个桶），覆盖 1 us ~ 约 67 s，百分位由桶边界估算。
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBuckets = 8;
+    static constexpr int kBucketCount = 26 * kSubBuckets;
+
+    struct Summary {
+        uint64_t count = 0;
+        double mean_us = 0;
+        double p50_us = 0;
+        double p90_us = 0;
+        double p99_us = 0;
+        double max_us = 0;
+    };
+
+    LatencyHistogram() {
+        reset();
+    }
+
+    void record(uint64_t latency_ns) {
+        m_buckets[bucketIndex(latency_ns)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum_ns.fetch_add(latency_ns, std::memory_order_relaxed);
+
+        uint64_t max_ns = m_max_ns.load(std::memory_order_relaxed);
+        while (latency_ns > max_ns &&
+               !m_max_ns.compare_exchange_weak(max_ns, latency_ns, std::memory_order_relaxed)) {}
+    }
+
+    void reset() {
+        for (auto &bucket : m_buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_sum_ns.store(0, std::memory_order_relaxed);
+        m_max_ns.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 统计当前直方图
+     * @param reset_after - 统计后清零，用于按周期滚动
+     */
+    Summary summarize(bool reset_after = false) {
+        uint64_t buckets[kBucketCount];
+        Summary summary;
+
+        for (int i = 0; i < kBucketCount; i++) {
+            buckets[i] = reset_after ? m_buckets[i].exchange(0, std::memory_order_relaxed)
+                                     : m_buckets[i].load(std::memory_order_relaxed);
+            summary.count += buckets[i];
+        }
+        uint64_t sum_ns = reset_after ? m_sum_ns.exchange(0) : m_sum_ns.load();
+        uint64_t max_ns = reset_after ? m_max_ns.exchange(0) : m_max_ns.load();
+        if (reset_after) m_count.store(0, std::memory_order_relaxed);
+
+        if (summary.count == 0) return summary;
+
+        summary.mean_us = (double) sum_ns / summary.count / 1000.0;
+        summary.max_us = (double) max_ns / 1000.0;
+        summary.p50_us = std::min(percentile(buckets, summary.count, 0.50), summary.max_us);
+        summary.p90_us = std::min(percentile(buckets, summary.count, 0.90), summary.max_us);
+        summary.p99_us = std::min(percentile(buckets, summary.count, 0.99), summary.max_us);
+
+        return summary;
+    }
+
+private:
+    static int bucketIndex(uint64_t latency_ns) {
+        double us = latency_ns / 1000.0;
+        if (us <= 1.0) return 0;
+
+        int index = (int) (std::log2(us) * kSubBuckets);
+        return index < kBucketCount ? index : kBucketCount - 1;
+    }
+
+    static double bucketUpperUs(int index) {
+        return std::exp2((double) (index + 1) / kSubBuckets);
+    }
+
+    static double percentile(const uint64_t *buckets, uint64_t count, double q) {
+        uint64_t target = (uint64_t) std::ceil(q * count);
+        uint64_t accumulated = 0;
+        for (int i = 0; i < kBucketCount; i++) {
+            accumulated += buckets[i];
+            if (accumulated >= target) return bucketUpperUs(i);
+        }
+
+        return bucketUpperUs(kBucketCount - 1);
+    }
+
+private:
+    std::atomic<uint64_t> m_buckets[kBucketCount];
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum_ns;
+    std::atomic<uint64_t> m_max_ns;
+};
+
+
+/**
+ * @brief 每帧的时间戳（主机 steady_clock，单位 ns），0 表示尚未经过该阶段
+ */
+struct FrameTiming {
+    uint64_t callback_ns = 0;                // 进入采集回调
+    uint64_t copy_done_ns = 0;               // 拷贝完成并发布
+    std::atomic<uint64_t> pickup_ns{0};      // 首次被消费者取走
+    std::atomic<uint64_t> paint_ns{0};       // 首次被 VideoWidget 绘制
+
+    void reset() {
+        callback_ns = 0;
+        copy_done_ns = 0;
+        pickup_ns.store(0, std::memory_order_relaxed);
+        paint_ns.store(0, std::memory_order_relaxed);
+    }
+};
+
+
+/**
+ * @brief 采集链路的延迟与丢帧统计
+ *
+ * 阶段：callback -> copy_done（拷贝）-> pickup（消费者取帧）-> paint（显示）。
+ * 丢帧分四类：SDK 帧号不连续（sdk_dropped）、帧池耗尽（pool_dropped）、格式转换队列已满（convert_dropped）、
+ * 发布后未被任何消费者取走就被覆盖（skipped）。需要格式转换时 copy 阶段包含排队与转换时间。
+ */
+class FrameMetrics {
+public:
+    struct Snapshot {
+        uint64_t frames_received = 0;
+        uint64_t frames_published = 0;
+        uint64_t frames_picked_up = 0;
+        uint64_t frames_painted = 0;
+        uint64_t sdk_dropped = 0;
+        uint64_t pool_dropped = 0;
+        uint64_t convert_dropped = 0;
+        uint64_t skipped = 0;
+
+        LatencyHistogram::Summary copy;          // callback -> copy_done
+        LatencyHistogram::Summary pickup;        // copy_done -> pickup
+        LatencyHistogram::Summary display;       // copy_done -> paint
+        LatencyHistogram::Summary end_to_end;    // callback -> paint
+        LatencyHistogram::Summary convert;       // 原始帧拷贝完成 -> 格式转换完成（仅需转换的格式）
+        LatencyHistogram::Summary trigger;       // 软触发 -> callback（仅 triggerAndWait）
+    };
+
+    FrameMetrics() {
+        reset();
+    }
+
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void reset() {
+        m_frames_received = 0;
+        m_frames_published = 0;
+        m_frames_picked_up = 0;
+        m_frames_painted = 0;
+        m_sdk_dropped = 0;
+        m_pool_dropped = 0;
+        m_convert_dropped = 0;
+        m_skipped = 0;
+        m_last_frame_id = 0;
+        m_has_last_frame_id = false;
+        m_last_pickup_sequence = 0;
+
+        m_copy.reset();
+        m_pickup.reset();
+        m_display.reset();
+        m_end_to_end.reset();
+        m_convert.reset();
+        m_trigger.reset();
+    }
+
+    // ---------- 采集回调线程 ----------
+
+    void recordReceived(uint64_t frame_id) {
+        m_frames_received.fetch_add(1, std::memory_order_relaxed);
+
+        if (m_has_last_frame_id && frame_id > m_last_frame_id + 1) {
+            m_sdk_dropped.fetch_add(frame_id - m_last_frame_id - 1, std::memory_order_relaxed);
+        }
+        m_last_frame_id = frame_id;
+        m_has_last_frame_id = true;
+    }
+
+    void recordPoolDropped() {
+        m_pool_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void recordConvertDropped() {
+        m_convert_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void recordConverted(uint64_t latency_ns) {
+        m_convert.record(latency_ns);
+    }
+
+    void recordPublished(const FrameTiming &timing) {
+        m_frames_published.fetch_add(1, std::memory_order_relaxed);
+        m_copy.record(timing.copy_done_ns - timing.callback_ns);
+    }
+
+    void recordTrigger(uint64_t latency_ns) {
+        m_trigger.record(latency_ns);
+    }
+
+    // ---------- 消费者线程 ----------
+
+    /**
+     * @brief 记录消费者取帧，只统计每帧的首次取走
+     * @param sequence - 帧的发布序号，用于统计未被取走就被覆盖的帧
+     */
+    void recordPickup(FrameTiming &timing, uint64_t sequence) {
+        uint64_t expected = 0;
+        uint64_t t = now();
+        if (!timing.pickup_ns.compare_exchange_strong(expected, t, std::memory_order_relaxed)) return;
+
+        m_frames_picked_up.fetch_add(1, std::memory_order_relaxed);
+        if (timing.copy_done_ns != 0) m_pickup.record(t - timing.copy_done_ns);
+
+        uint64_t last = m_last_pickup_sequence.load(std::memory_order_relaxed);
+        while (sequence > last) {
+            if (m_last_pickup_sequence.compare_exchange_weak(last, sequence, std::memory_order_relaxed)) {
+                if (last != 0 && sequence > last + 1) {
+                    m_skipped.fetch_add(sequence - last - 1, std::memory_order_relaxed);
+                }
+                break;
+            }
+        }
+    }
+
+    void recordPaint(FrameTiming &timing) {
+        uint64_t expected = 0;
+        uint64_t t = now();
+        if (!timing.paint_ns.compare_exchange_strong(expected, t, std::memory_order_relaxed)) return;
+
+        m_frames_painted.fetch_add(1, std::memory_order_relaxed);
+        if (timing.copy_done_ns != 0) m_display.record(t - timing.copy_done_ns);
+        if (timing.callback_ns != 0) m_end_to_end.record(t - timing.callback_ns);
+    }
+
+    // ---------- 查询 ----------
+
+    /**
+     * @brief 获取统计快照
+     * @param reset_histograms - 读取后清空直方图（计数器不清零），用于周期性输出滚动统计
+     */
+    Snapshot snapshot(bool reset_histograms = false) {
+        Snapshot s;
+        s.frames_received = m_frames_received.load(std::memory_order_relaxed);
+        s.frames_published = m_frames_published.load(std::memory_order_relaxed);
+        s.frames_picked_up = m_frames_picked_up.load(std::memory_order_relaxed);
+        s.frames_painted = m_frames_painted.load(std::memory_order_relaxed);
+        s.sdk_dropped = m_sdk_dropped.load(std::memory_order_relaxed);
+        s.pool_dropped = m_pool_dropped.load(std::memory_order_relaxed);
+        s.convert_dropped = m_convert_dropped.load(std::memory_order_relaxed);
+        s.skipped = m_skipped.load(std::memory_order_relaxed);
+
+        s.copy = m_copy.summarize(reset_histograms);
+        s.pickup = m_pickup.summarize(reset_histograms);
+        s.display = m_display.summarize(reset_histograms);
+        s.end_to_end = m_end_to_end.summarize(reset_histograms);
+        s.convert = m_convert.summarize(reset_histograms);
+        s.trigger = m_trigger.summarize(reset_histograms);
+
+        return s;
+    }
+
+    static std::string format(const Snapshot &s) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(1)
+           << "frames recv " << s.frames_received << " pub " << s.frames_published
+           << " pick " << s.frames_picked_up << " paint " << s.frames_painted
+           << " | drop sdk " << s.sdk_dropped << " pool " << s.pool_dropped
+           << " conv " << s.convert_dropped << " skip " << s.skipped;
+
+        auto stage = [&ss](const char *name, const LatencyHistogram::Summary &h) {
+            ss << " | " << name << " p50/p99/max " << h.p50_us << "/" << h.p99_us << "/" << h.max_us << " us";
+        };
+        stage("copy", s.copy);
+        stage("pickup", s.pickup);
+        stage("display", s.display);
+        stage("e2e", s.end_to_end);
+        if (s.convert.count > 0) stage("convert", s.convert);
+        if (s.trigger.count > 0) stage("trigger", s.trigger);
+
+        return ss.str();
+    }
+
+private:
+    std::atomic<uint64_t> m_frames_received;
+    std::atomic<uint64_t> m_frames_published;
+    std::atomic<uint64_t> m_frames_picked_up;
+    std::atomic<uint64_t> m_frames_painted;
+    std::atomic<uint64_t> m_sdk_dropped;
+    std::atomic<uint64_t> m_pool_dropped;
+    std::atomic<uint64_t> m_convert_dropped;
+    std::atomic<uint64_t> m_skipped;
+
+    uint64_t m_last_frame_id;                       // 仅采集回调线程访问
+    bool m_has_last_frame_id;
+    std::atomic<uint64_t> m_last_pickup_sequence;
+
+    LatencyHistogram m_copy;
+    LatencyHistogram m_pickup;
+    LatencyHistogram m_display;
+    LatencyHistogram m_end_to_end;
+    LatencyHistogram m_convert;
+    LatencyHistogram m_trigger;
+};
+
+
+#endif // FRAME_METRICS_HPP
@@ -0,0 +1,367 @@
+#ifndef FRAME_PIPELINE_HPP
+#define FRAME_PIPELINE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frame_metrics.hpp"
+#include "frame_pool.hpp"
+
+
+/**
+ * @brief 多级帧处理流水线
+ *
+ * 每一级有自己的有界队列与若干工作线程，同一级的多个线程并行处理不同的帧，
+ * 处理结果经重排后按进入该级的顺序交给下一级，最后一级按顺序调用输出回调。
+ *
+ * 队列满时按该级的策略处理：DropOldest 丢弃队列中最旧的帧（实时显示），Block 阻塞上一级（离线处理不丢帧）。
+ * 处理函数返回 false 表示丢弃该帧（如未通过筛选），也可以把 frame 替换为新的帧（如校正后的图像）。
+ *
+ * 注意：流水线中的帧占用帧池，各级容量与线程数之和应小于帧池大小。
+ */
+class FramePipeline {
+public:
+    enum class OverflowPolicy {
+        DropOldest,
+        Block,
+    };
+
+    using StageFunc = std::function<bool(FrameRef &frame)>;
+    using OutputFunc = std::function<void(const FrameRef &frame)>;
+
+    struct StageStats {
+        std::string name;
+        int workers = 0;
+        uint64_t processed = 0;           // 处理完成并交给下一级的帧数
+        uint64_t dropped_overflow = 0;    // 队列满被丢弃的帧数
+        uint64_t dropped_by_stage = 0;    // 处理函数返回 false 的帧数
+        size_t queue_depth = 0;
+        size_t max_queue_depth = 0;
+        size_t queue_capacity = 0;
+        LatencyHistogram::Summary process; // 单帧处理耗时
+    };
+
+    FramePipeline()
+            : m_running(false) {}
+
+    ~FramePipeline() {
+        stop();
+    }
+
+    FramePipeline(const FramePipeline &) = delete;
+    FramePipeline &operator=(const FramePipeline &) = delete;
+
+    /**
+     * @brief 追加一级，只能在 start() 之前调用
+     * @param workers - 工作线程数
+     * @param queue_capacity - 等待处理的最大帧数
+     * @return 该级的序号
+     */
+    size_t addStage(const std::string &name, StageFunc func, int workers = 1, size_t queue_capacity = 4,
+                    OverflowPolicy policy = OverflowPolicy::DropOldest) {
+        std::unique_ptr<Stage> stage(new Stage());
+        stage->name = name;
+        stage->func = std::move(func);
+        stage->workers = std::max(workers, 1);
+        stage->capacity = std::max<size_t>(queue_capacity, 1);
+        stage->policy = policy;
+
+        m_stages.push_back(std::move(stage));
+
+        return m_stages.size() - 1;
+    }
+
+    /**
+     * @brief 设置输出回调，按帧进入流水线的顺序在最后一级的工作线程中串行调用，应尽量轻量
+     */
+    void setOutput(OutputFunc output) {
+        m_output = std::move(output);
+    }
+
+    bool start() {
+        if (m_running || m_stages.empty()) return false;
+
+        for (auto &stage : m_stages) {
+            stage->stop_flag = false;
+            stage->queue.clear();
+            stage->reorder.clear();
+            stage->next_input_index = 0;
+            stage->next_output_index = 0;
+            stage->released_index = 0;
+            stage->forwarding = false;
+            stage->max_queue_depth = 0;
+        }
+
+        for (size_t i = 0; i < m_stages.size(); i++) {
+            for (int n = 0; n < m_stages[i]->workers; n++) {
+                m_stages[i]->threads.emplace_back(&FramePipeline::workLoop, this, i);
+            }
+        }
+        m_running = true;
+
+        return true;
+    }
+
+    /**
+     * @brief 停止所有工作线程，丢弃尚未处理的帧
+     */
+    void stop() {
+        if (!m_running) return;
+        m_running = false;
+
+        for (auto &stage : m_stages) {
+            {
+                std::lock_guard<std::mutex> locker(stage->mutex);
+                stage->stop_flag = true;
+            }
+            stage->not_empty.notify_all();
+            stage->not_full.notify_all();
+        }
+
+        for (auto &stage : m_stages) {
+            for (auto &thread : stage->threads) {
+                thread.join();
+            }
+            stage->threads.clear();
+            stage->queue.clear();
+            stage->reorder.clear();
+        }
+    }
+
+    bool isRunning() const {
+        return m_running;
+    }
+
+    /**
+     * @brief 送入一帧，第一级为 Block 策略且队列已满时阻塞
+     */
+    bool push(const FrameRef &frame) {
+        if (!m_running || !frame) return false;
+
+        return enqueue(0, frame, true);
+    }
+
+    /**
+     * @brief 送入一帧，不阻塞（可在采集线程中调用）：Block 策略下队列已满时拒绝新帧并计入 dropped_overflow
+     *
+     * 只短暂持有第一级的队列锁，不会等待任何一级的处理或输出回调。
+     */
+    bool tryPush(const FrameRef &frame) {
+        if (!m_running || !frame) return false;
+
+        return enqueue(0, frame, false);
+    }
+
+    std::vector<StageStats> stats() {
+        std::vector<StageStats> result;
+
+        for (auto &stage : m_stages) {
+            StageStats s;
+            s.name = stage->name;
+            s.workers = stage->workers;
+            s.processed = stage->processed.load(std::memory_order_relaxed);
+            s.dropped_overflow = stage->dropped_overflow.load(std::memory_order_relaxed);
+            s.dropped_by_stage = stage->dropped_by_stage.load(std::memory_order_relaxed);
+            s.queue_capacity = stage->capacity;
+            {
+                std::lock_guard<std::mutex> locker(stage->mutex);
+                s.queue_depth = stage->queue.size();
+                s.max_queue_depth = stage->max_queue_depth;
+            }
+            s.process = stage->process_time.summarize();
+
+            result.push_back(s);
+        }
+
+        return result;
+    }
+
+    static std::string format(const std::vector<StageStats> &stats) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(1);
+
+        for (size_t i = 0; i < stats.size(); i++) {
+            const StageStats &s = stats[i];
+            if (i > 0) ss << " | ";
+            ss << s.name << " x" << s.workers << " done " << s.processed
+               << " drop " << s.dropped_overflow << "/" << s.dropped_by_stage
+               << " queue " << s.queue_depth << "/" << s.queue_capacity << " (max " << s.max_queue_depth << ")"
+               << " p50/p99 " << s.process.p50_us << "/" << s.process.p99_us << " us";
+        }
+
+        return ss.str();
+    }
+
+private:
+    struct Item {
+        uint64_t index;      // 进入本级的顺序号
+        FrameRef frame;
+    };
+
+    struct Stage {
+        std::string name;
+        StageFunc func;
+        int workers = 1;
+        size_t capacity = 4;
+        OverflowPolicy policy = OverflowPolicy::DropOldest;
+
+        std::mutex mutex;
+        std::condition_variable not_empty;
+        std::condition_variable not_full;
+        std::deque<Item> queue;
+        std::map<uint64_t, FrameRef> reorder;    // 已处理完成、等待按序输出的帧，空句柄表示已丢弃
+        uint64_t next_input_index = 0;
+        uint64_t next_output_index = 0;          // 下一个从重排表取出的序号
+        uint64_t released_index = 0;             // 此前的帧已交给下一级，重排窗口以此为起点
+        bool forwarding = false;                 // 已有线程在按序交出帧
+        bool stop_flag = false;
+        size_t max_queue_depth = 0;
+
+        std::vector<std::thread> threads;
+
+        std::atomic<uint64_t> processed{0};
+        std::atomic<uint64_t> dropped_overflow{0};
+        std::atomic<uint64_t> dropped_by_stage{0};
+        LatencyHistogram process_time;
+    };
+
+    // 调用方需保证同一级的入队按顺序进行：第一级由 push 调用方保证，其余由上一级的按序输出保证
+    bool enqueue(size_t stage_index, const FrameRef &frame, bool wait) {
+        Stage &stage = *m_stages[stage_index];
+
+        std::unique_lock<std::mutex> locker(stage.mutex);
+
+        if (stage.queue.size() >= stage.capacity) {
+            if (stage.policy == OverflowPolicy::DropOldest) {
+                // 丢弃最旧的帧，在重排表中留空位。比它更早的帧都已被取出，处理完成后由工作线程越过空位；
+                // 没有更早的帧时，新入队的帧处理完成后越过空位，送帧方不必自己推进输出
+                stage.reorder[stage.queue.front().index] = FrameRef();
+                stage.queue.pop_front();
+                stage.dropped_overflow.fetch_add(1, std::memory_order_relaxed);
+            } else if (!wait) {
+                stage.dropped_overflow.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                stage.not_full.wait(locker, [&stage]() {
+                    return stage.stop_flag || stage.queue.size() < stage.capacity;
+                });
+                if (stage.stop_flag) return false;
+            }
+        }
+
+        stage.queue.push_back({stage.next_input_index++, frame});
+        stage.max_queue_depth = std::max(stage.max_queue_depth, stage.queue.size());
+
+        locker.unlock();
+        stage.not_empty.notify_one();
+
+        return true;
+    }
+
+    void workLoop(size_t stage_index) {
+        Stage &stage = *m_stages[stage_index];
+
+        // 重排窗口：限制已取出但尚未按序输出的帧数，避免单个慢帧导致重排表无限增长
+        uint64_t window = stage.capacity + stage.workers;
+
+        while (true) {
+            Item item;
+            {
+                std::unique_lock<std::mutex> locker(stage.mutex);
+                stage.not_empty.wait(locker, [&stage, window]() {
+                    return stage.stop_flag ||
+                           (!stage.queue.empty() && stage.queue.front().index < stage.released_index + window);
+                });
+                if (stage.stop_flag) break;
+
+                item = std::move(stage.queue.front());
+                stage.queue.pop_front();
+            }
+            stage.not_full.notify_one();
+
+            uint64_t begin_ns = FrameMetrics::now();
+            bool keep = stage.func(item.frame) && item.frame;
+            stage.process_time.record(FrameMetrics::now() - begin_ns);
+
+            if (!keep) {
+                stage.dropped_by_stage.fetch_add(1, std::memory_order_relaxed);
+                item.frame.reset();
+            }
+
+            {
+                std::lock_guard<std::mutex> locker(stage.mutex);
+                stage.reorder[item.index] = std::move(item.frame);
+            }
+
+            forward(stage_index);
+        }
+    }
+
+    /**
+     * @brief 把本级已按序就绪的帧交给下一级（或输出回调）
+     *
+     * 同一时刻只有一个线程按序交出帧：在本级锁内取出就绪的帧，释放锁后再交给下一级或输出回调。
+     * 下一级为 Block 策略且已满时只阻塞交出帧的线程，形成背压；本级其它工作线程与送帧方不会因此等待本级锁。
+     */
+    void forward(size_t stage_index) {
+        Stage &stage = *m_stages[stage_index];
+        bool last = stage_index + 1 == m_stages.size();
+        std::vector<FrameRef> ready;
+
+        std::unique_lock<std::mutex> locker(stage.mutex);
+
+        // 正在交出帧的线程交完后会重新检查重排表
+        if (stage.forwarding) return;
+        stage.forwarding = true;
+
+        while (!stage.stop_flag) {
+            uint64_t end_index = stage.next_output_index;
+            for (auto it = stage.reorder.find(end_index); it != stage.reorder.end(); it = stage.reorder.find(end_index)) {
+                if (it->second) ready.push_back(std::move(it->second));
+                stage.reorder.erase(it);
+                end_index++;
+            }
+            if (end_index == stage.next_output_index) break;
+            stage.next_output_index = end_index;
+
+            locker.unlock();
+
+            for (const FrameRef &frame : ready) {
+                stage.processed.fetch_add(1, std::memory_order_relaxed);
+                if (last) {
+                    if (m_output) m_output(frame);
+                } else {
+                    enqueue(stage_index + 1, frame, true);
+                }
+            }
+            ready.clear();
+
+            locker.lock();
+
+            // 交出后，受重排窗口限制的工作线程可以继续取帧
+            stage.released_index = end_index;
+            stage.not_empty.notify_all();
+        }
+
+        stage.forwarding = false;
+    }
+
+private:
+    std::vector<std::unique_ptr<Stage>> m_stages;
+    OutputFunc m_output;
+    std::atomic<bool> m_running;
+};
+
+
+#endif // FRAME_PIPELINE_HPP
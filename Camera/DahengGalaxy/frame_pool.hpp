@@ -0,0 +1,206 @@
+#ifndef FRAME_POOL_HPP
+#define FRAME_POOL_HPP
+
+#include <QImage>
+#include <QMetaType>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+#include "frame_metrics.hpp"
+#include "frame_statistics.hpp"
+
+
+/**
+ * @brief 帧对象，图像内存由 FramePool 预先分配并循环使用
+ */
+struct Frame {
+    std::vector<uint8_t> data;
+
+    int width = 0;
+    int height = 0;
+    int step = 0;                                        // 每行字节数
+    int cv_type = CV_8UC1;
+    QImage::Format qimage_format = QImage::Format_Grayscale8;
+
+    uint64_t frame_id = 0;                               // SDK 帧号
+    uint64_t timestamp = 0;                              // SDK 时间戳
+    uint64_t sequence = 0;                               // 发布序号，从 1 开始连续递增
+
+    FrameTiming timing;                                  // 各阶段的主机时间戳
+    FrameStatistics statistics;                          // 发布前计算的灰度统计，未开启时 valid 为 false
+};
+
+
+/**
+ * @brief 帧句柄，引用计数归零时帧对象自动归还给 FramePool
+ *
+ * mat() 返回的 cv::Mat 不持有引用，只在句柄存活期间有效；toQImage() 返回的 QImage 自身持有引用，
+ * 可以安全地跨线程传递，直到最后一个 QImage 副本析构时才释放帧对象。
+ */
+class FrameRef {
+public:
+    FrameRef() = default;
+
+    explicit FrameRef(std::shared_ptr<Frame> frame)
+            : m_frame(std::move(frame)) {}
+
+    bool isNull() const {
+        return m_frame == nullptr;
+    }
+
+    explicit operator bool() const {
+        return m_frame != nullptr;
+    }
+
+    Frame *operator->() const {
+        return m_frame.get();
+    }
+
+    Frame &operator*() const {
+        return *m_frame;
+    }
+
+    void reset() {
+        m_frame.reset();
+    }
+
+    long useCount() const {
+        return m_frame.use_count();
+    }
+
+    cv::Mat mat() const {
+        if (!m_frame) return cv::Mat();
+
+        return cv::Mat(m_frame->height, m_frame->width, m_frame->cv_type, m_frame->data.data(), m_frame->step);
+    }
+
+    QImage toQImage() const {
+        if (!m_frame) return QImage();
+
+        return QImage(m_frame->data.data(), m_frame->width, m_frame->height, m_frame->step, m_frame->qimage_format,
+                      [](void *info) { delete static_cast<FrameRef *>(info); },
+                      new FrameRef(*this));
+    }
+
+private:
+    std::shared_ptr<Frame> m_frame;
+};
+
+Q_DECLARE_METATYPE(FrameRef)
+
+
+/**
+ * @brief 预分配的帧对象池
+ *
+ * acquire() 无锁且不分配图像内存，池耗尽时返回空句柄，由调用方决定丢帧。
+ * 重新分配（allocate）后，仍被持有的旧帧在最后一个引用释放时随旧池一起析构。
+ */
+class FramePool {
+public:
+    FramePool() = default;
+
+    ~FramePool() = default;
+
+    FramePool(const FramePool &) = delete;
+    FramePool &operator=(const FramePool &) = delete;
+
+    /**
+     * @brief 按帧尺寸分配帧池，只能在没有 acquire 并发调用时调用
+     * @param frame_count - 帧对象个数
+     * @param buffer_size - 每帧的字节数
+     */
+    void allocate(size_t frame_count, size_t buffer_size) {
+        auto state = std::make_shared<State>(frame_count);
+        for (auto &frame : state->frames) {
+            frame.data.assign(buffer_size, 0);
+        }
+
+        m_state = std::move(state);
+        m_buffer_size = buffer_size;
+    }
+
+    void release() {
+        m_state.reset();
+        m_buffer_size = 0;
+    }
+
+    /**
+     * @brief 根据单帧大小与内存预算计算帧池大小
+     */
+    static size_t frameCountForBudget(size_t buffer_size, size_t memory_budget = 256 * 1024 * 1024,
+                                      size_t min_count = 6, size_t max_count = 32) {
+        if (buffer_size == 0) return min_count;
+
+        size_t count = memory_budget / buffer_size;
+        if (count < min_count) count = min_count;
+        if (count > max_count) count = max_count;
+
+        return count;
+    }
+
+    FrameRef acquire() {
+        std::shared_ptr<State> state = m_state;
+        if (!state) return FrameRef();
+
+        size_t count = state->frames.size();
+        size_t start = state->next.fetch_add(1, std::memory_order_relaxed);
+        for (size_t n = 0; n < count; n++) {
+            size_t index = (start + n) % count;
+
+            bool expected = false;
+            if (state->in_use[index].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                // 删除器持有 state，保证帧归还前帧池不会被析构
+                return FrameRef(std::shared_ptr<Frame>(&state->frames[index], [state, index](Frame *) {
+                    state->in_use[index].store(false, std::memory_order_release);
+                }));
+            }
+        }
+
+        return FrameRef();
+    }
+
+    size_t frameCount() const {
+        return m_state ? m_state->frames.size() : 0;
+    }
+
+    size_t bufferSize() const {
+        return m_buffer_size;
+    }
+
+    size_t framesInUse() const {
+        if (!m_state) return 0;
+
+        size_t n = 0;
+        for (size_t i = 0; i < m_state->frames.size(); i++) {
+            if (m_state->in_use[i].load(std::memory_order_relaxed)) n++;
+        }
+
+        return n;
+    }
+
+private:
+    struct State {
+        explicit State(size_t count)
+                : frames(count),
+                  in_use(new std::atomic<bool>[count]),
+                  next(0) {
+            for (size_t i = 0; i < count; i++) {
+                in_use[i].store(false, std::memory_order_relaxed);
+            }
+        }
+
+        std::vector<Frame> frames;
+        std::unique_ptr<std::atomic<bool>[]> in_use;
+        std::atomic<size_t> next;
+    };
+
+    std::shared_ptr<State> m_state;
+    size_t m_buffer_size = 0;
+};
+
+
+#endif // FRAME_POOL_HPP
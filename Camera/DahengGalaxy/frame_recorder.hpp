@@ -0,0 +1,264 @@
+#ifndef FRAME_RECORDER_HPP
+#define FRAME_RECORDER_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+
+#include "frame_pool.hpp"
+#include "frame_sequence_file.hpp"
+#include "spsc_queue.hpp"
+
+
+/**
+ * @brief 异步帧录制器
+ *
+ * 采集线程通过 push() 将帧句柄放入有界无锁队列（零拷贝，不会阻塞），队列满时丢帧并计数；
+ * 独立写线程每次取出队列中的全部帧，合并为一次写入预分配的帧序列文件，并每秒回写一次索引与帧数。
+ *
+ * 注意：队列中的帧占用帧池，队列容量应小于帧池大小，否则会挤占实时显示所需的帧。
+ */
+class FrameRecorder {
+public:
+    struct Stats {
+        uint64_t frames_pushed = 0;           // 进入队列的帧数
+        uint64_t frames_written = 0;          // 写入文件的帧数
+        uint64_t dropped_queue_full = 0;      // 队列满（写盘跟不上）丢弃的帧数
+        uint64_t dropped_file_full = 0;       // 文件容量已满丢弃的帧数
+        uint64_t write_errors = 0;
+        size_t queue_depth = 0;
+        size_t max_queue_depth = 0;
+        size_t queue_capacity = 0;
+        double write_mb_per_sec = 0;          // 录制开始以来的平均写入速度，停止后保持停止时的值
+    };
+
+    FrameRecorder()
+            : m_recording(false),
+              m_pushing(0),
+              m_stop_flag(false),
+              m_start_ns(0),
+              m_stop_ns(0) {
+        resetStats();
+    }
+
+    ~FrameRecorder() {
+        stop();
+    }
+
+    FrameRecorder(const FrameRecorder &) = delete;
+    FrameRecorder &operator=(const FrameRecorder &) = delete;
+
+    /**
+     * @brief 开始录制
+     * @param path - 帧序列文件路径
+     * @param capacity_frames - 预分配的帧数
+     * @param queue_capacity - 等待写盘的最大帧数
+     */
+    bool start(const std::string &path, int width, int height, int cv_type, int step,
+               uint64_t capacity_frames, size_t queue_capacity = 8) {
+        stop();
+
+        if (!m_writer.open(path, width, height, cv_type, step, capacity_frames)) return false;
+
+        // stop() 已等待生产者离开，此时重置队列不会与 push() 竞争
+        m_queue.reset(queue_capacity);
+        resetStats();
+        m_start_ns = steadyNowNs();
+        m_stop_ns = 0;
+        m_stop_flag = false;
+        m_thread = std::thread(&FrameRecorder::writeLoop, this);
+        m_recording.store(true, std::memory_order_seq_cst);
+
+        return true;
+    }
+
+    /**
+     * @brief 停止录制，写完队列中剩余的帧后回写索引并关闭文件
+     */
+    void stop() {
+        // 关闭入口并等待正在入队的生产者离开
+        m_recording.store(false, std::memory_order_seq_cst);
+        while (m_pushing.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+
+        if (!m_thread.joinable()) return;
+
+        m_stop_flag = true;
+        m_cond.notify_all();
+        m_thread.join();
+
+        m_writer.close();
+        m_stop_ns = steadyNowNs();
+    }
+
+    bool isRecording() const {
+        return m_recording;
+    }
+
+    /**
+     * @brief 由采集线程调用，只能有一个生产者线程
+     * @return 帧是否进入队列
+     */
+    bool push(const FrameRef &frame) {
+        if (!frame) return false;
+
+        // 先登记再检查入口，与 stop() 配对，保证 start() 重置队列时没有生产者在入队
+        m_pushing.fetch_add(1, std::memory_order_seq_cst);
+        bool ok = m_recording.load(std::memory_order_seq_cst) && enqueue(frame);
+        m_pushing.fetch_sub(1, std::memory_order_seq_cst);
+
+        return ok;
+    }
+
+    Stats stats() const {
+        Stats s;
+        s.frames_pushed = m_frames_pushed.load(std::memory_order_relaxed);
+        s.frames_written = m_frames_written.load(std::memory_order_relaxed);
+        s.dropped_queue_full = m_dropped_queue_full.load(std::memory_order_relaxed);
+        s.dropped_file_full = m_dropped_file_full.load(std::memory_order_relaxed);
+        s.write_errors = m_write_errors.load(std::memory_order_relaxed);
+        s.queue_depth = m_queue.size();
+        s.max_queue_depth = m_max_queue_depth.load(std::memory_order_relaxed);
+        s.queue_capacity = m_queue.capacity();
+
+        int64_t end_ns = m_stop_ns.load(std::memory_order_relaxed);
+        if (end_ns == 0) end_ns = steadyNowNs();
+        double seconds = (double) (end_ns - m_start_ns.load(std::memory_order_relaxed)) / 1e9;
+        if (seconds > 0) {
+            s.write_mb_per_sec = (double) m_bytes_written.load(std::memory_order_relaxed) / (1024.0 * 1024.0) / seconds;
+        }
+
+        return s;
+    }
+
+private:
+    static constexpr int kSyncIntervalMs = 1000;
+
+    static int64_t steadyNowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool enqueue(const FrameRef &frame) {
+        if (m_file_full) {
+            m_dropped_file_full.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if (!m_queue.tryPush(frame)) {
+            m_dropped_queue_full.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        m_frames_pushed.fetch_add(1, std::memory_order_relaxed);
+
+        size_t depth = m_queue.size();
+        if (depth > m_max_queue_depth.load(std::memory_order_relaxed)) {
+            m_max_queue_depth.store(depth, std::memory_order_relaxed);
+        }
+
+        m_cond.notify_one();
+
+        return true;
+    }
+
+    void resetStats() {
+        m_frames_pushed = 0;
+        m_frames_written = 0;
+        m_dropped_queue_full = 0;
+        m_dropped_file_full = 0;
+        m_write_errors = 0;
+        m_bytes_written = 0;
+        m_max_queue_depth = 0;
+        m_file_full = false;
+    }
+
+    void writeLoop() {
+        std::vector<FrameRef> batch;
+        std::vector<FrameSequenceWriteItem> items;
+        batch.reserve(m_queue.capacity());
+        items.reserve(m_queue.capacity());
+
+        auto last_sync = std::chrono::steady_clock::now();
+
+        while (true) {
+            // 生产者不加锁通知，这里用超时等待兜底，最多延迟一个等待周期
+            {
+                std::unique_lock<std::mutex> locker(m_mutex);
+                m_cond.wait_for(locker, std::chrono::milliseconds(5), [this]() {
+                    return m_stop_flag || !m_queue.empty();
+                });
+            }
+
+            // 一次取出全部待写帧，合并为一次写入
+            FrameRef frame;
+            while (m_queue.tryPop(frame)) {
+                batch.push_back(std::move(frame));
+            }
+
+            if (!batch.empty()) {
+                for (auto &item : batch) {
+                    items.push_back({item->data.data(), item->frame_id, item->timestamp, item->timing.callback_ns});
+                }
+
+                size_t room = (size_t) std::min<uint64_t>(items.size(), m_writer.header().capacity - m_writer.frameCount());
+                size_t written = m_writer.append(items.data(), items.size());
+
+                if (written > 0) {
+                    m_frames_written.fetch_add(written, std::memory_order_relaxed);
+                    m_bytes_written.fetch_add(written * m_writer.frameSize(), std::memory_order_relaxed);
+                } else {
+                    m_write_errors.fetch_add(room, std::memory_order_relaxed);
+                }
+                if (items.size() > room) {
+                    m_file_full = true;
+                    m_dropped_file_full.fetch_add(items.size() - room, std::memory_order_relaxed);
+                }
+
+                items.clear();
+                batch.clear();  // 归还帧池
+            }
+
+            // 定期回写索引与帧数，进程异常退出时最多丢失最后一个周期的帧
+            auto now = std::chrono::steady_clock::now();
+            if (now - last_sync >= std::chrono::milliseconds(kSyncIntervalMs)) {
+                m_writer.sync();
+                last_sync = now;
+            }
+
+            if (m_stop_flag && m_queue.empty()) break;
+        }
+    }
+
+private:
+    FrameSequenceWriter m_writer;
+    SpscQueue<FrameRef> m_queue;
+
+    std::atomic<bool> m_recording;           // 是否接收新帧
+    std::atomic<int> m_pushing;              // 正在 push() 中的生产者数
+    std::atomic<bool> m_stop_flag;
+    std::atomic<bool> m_file_full;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::thread m_thread;
+    std::atomic<int64_t> m_start_ns;
+    std::atomic<int64_t> m_stop_ns;          // 0 表示仍在录制
+
+    std::atomic<uint64_t> m_frames_pushed;
+    std::atomic<uint64_t> m_frames_written;
+    std::atomic<uint64_t> m_dropped_queue_full;
+    std::atomic<uint64_t> m_dropped_file_full;
+    std::atomic<uint64_t> m_write_errors;
+    std::atomic<uint64_t> m_bytes_written;
+    std::atomic<size_t> m_max_queue_depth;
+};
+
+
+#endif // FRAME_RECORDER_HPP
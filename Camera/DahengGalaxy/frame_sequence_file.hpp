@@ -0,0 +1,407 @@
+#ifndef FRAME_SEQUENCE_FILE_HPP
+#define FRAME_SEQUENCE_FILE_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+
+/**
+ * 帧序列文件格式（小端）
+ *
+ *   [0, 4096)                        FrameSequenceHeader
+ *   [index_offset, data_offset)      FrameSequenceIndexEntry[capacity]，按 4096 对齐
+ *   [data_offset, ...)               第 i 帧位于 data_offset + i * frame_stride，frame_stride 按 4096 对齐
+ *
+ * 文件在打开时按 capacity 预分配，录制过程中调用 sync() 先回写新增的索引、再回写帧数，进程异常退出时
+ * 最近一次 sync() 之前的帧仍可读取。帧数据按页对齐，便于内存映射后零拷贝访问。
+ */
+
+static constexpr char kFrameSequenceMagic[8] = {'F', 'R', 'M', 'S', 'E', 'Q', '0', '1'};
+static constexpr uint32_t kFrameSequenceVersion = 1;
+static constexpr uint64_t kFrameSequenceAlignment = 4096;
+
+struct FrameSequenceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    int32_t width;
+    int32_t height;
+    int32_t cv_type;
+    int32_t step;           // 每行字节数
+    uint64_t frame_size;    // 每帧图像数据字节数
+    uint64_t frame_stride;  // 相邻两帧的偏移间隔
+    uint64_t capacity;      // 预分配的帧数
+    uint64_t frame_count;   // 实际写入的帧数
+    uint64_t index_offset;
+    uint64_t data_offset;
+};
+
+struct FrameSequenceIndexEntry {
+    uint64_t frame_id;      // SDK 帧号
+    uint64_t timestamp;     // SDK 时间戳
+    uint64_t host_ns;       // 主机接收时间（steady_clock），用于按原始节奏回放
+    uint64_t offset;        // 帧数据在文件中的偏移
+};
+
+static_assert(sizeof(FrameSequenceHeader) == 80, "unexpected FrameSequenceHeader layout");
+static_assert(sizeof(FrameSequenceIndexEntry) == 32, "unexpected FrameSequenceIndexEntry layout");
+
+inline uint64_t frameSequenceAlignUp(uint64_t value) {
+    return (value + kFrameSequenceAlignment - 1) / kFrameSequenceAlignment * kFrameSequenceAlignment;
+}
+
+
+/**
+ * @brief 批量追加的一帧
+ */
+struct FrameSequenceWriteItem {
+    const void *data;
+    uint64_t frame_id;
+    uint64_t timestamp;
+    uint64_t host_ns;
+};
+
+
+/**
+ * @brief 帧序列文件写入器，只能按顺序追加
+ *
+ * 连续的多帧合并为一次写入（POSIX 下为 pwritev，Windows 下经暂存缓冲区一次 WriteFile）。
+ */
+class FrameSequenceWriter {
+public:
+    FrameSequenceWriter()
+            : m_synced_count(0) {
+        std::memset(&m_header, 0, sizeof(m_header));
+#ifdef _WIN32
+        m_file_handle = INVALID_HANDLE_VALUE;
+#else
+        m_fd = -1;
+#endif
+    }
+
+    ~FrameSequenceWriter() {
+        close();
+    }
+
+    FrameSequenceWriter(const FrameSequenceWriter &) = delete;
+    FrameSequenceWriter &operator=(const FrameSequenceWriter &) = delete;
+
+    /**
+     * @brief 创建文件并按容量预分配空间
+     * @param capacity - 最多可写入的帧数
+     */
+    bool open(const std::string &path, int width, int height, int cv_type, int step, uint64_t capacity) {
+        close();
+
+        if (width <= 0 || height <= 0 || step <= 0 || capacity == 0) return false;
+
+        std::memset(&m_header, 0, sizeof(m_header));
+        std::memcpy(m_header.magic, kFrameSequenceMagic, sizeof(m_header.magic));
+        m_header.version = kFrameSequenceVersion;
+        m_header.header_size = (uint32_t) kFrameSequenceAlignment;
+        m_header.width = width;
+        m_header.height = height;
+        m_header.cv_type = cv_type;
+        m_header.step = step;
+        m_header.frame_size = (uint64_t) step * height;
+        m_header.frame_stride = frameSequenceAlignUp(m_header.frame_size);
+        m_header.capacity = capacity;
+        m_header.frame_count = 0;
+        m_header.index_offset = kFrameSequenceAlignment;
+        m_header.data_offset = m_header.index_offset +
+                               frameSequenceAlignUp(capacity * sizeof(FrameSequenceIndexEntry));
+
+        if (!openFile(path)) {
+            std::cout << "Frame sequence file open error: " << path << std::endl;
+            return false;
+        }
+
+        // 按容量实际分配磁盘块，避免录制过程中文件系统反复扩展，磁盘空间不足时在此处失败
+        uint64_t total_size = m_header.data_offset + capacity * m_header.frame_stride;
+        if (!preallocate(total_size)) {
+            std::cout << "Frame sequence file preallocation error: " << path << std::endl;
+            closeFile();
+            return false;
+        }
+
+        m_index.clear();
+        m_index.reserve(capacity);
+        m_synced_count = 0;
+
+        if (!writeAt(0, &m_header, sizeof(m_header))) {
+            std::cout << "Frame sequence file write error: " << path << std::endl;
+            closeFile();
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief 追加一帧
+     * @return 文件已满或写入失败时返回 false
+     */
+    bool append(const void *data, uint64_t frame_id, uint64_t timestamp, uint64_t host_ns) {
+        FrameSequenceWriteItem item = {data, frame_id, timestamp, host_ns};
+        return append(&item, 1) == 1;
+    }
+
+    /**
+     * @brief 按顺序追加多帧，合并为尽量少的写入调用
+     * @return 写入的帧数；超出容量的帧不写入，写入失败时返回 0
+     */
+    size_t append(const FrameSequenceWriteItem *items, size_t count) {
+        if (!isOpen()) return 0;
+
+        count = (size_t) std::min<uint64_t>(count, m_header.capacity - m_header.frame_count);
+        if (count == 0) return 0;
+
+        uint64_t offset = m_header.data_offset + m_header.frame_count * m_header.frame_stride;
+        if (!writeFrames(offset, items, count)) return 0;
+
+        for (size_t i = 0; i < count; i++) {
+            m_index.push_back({items[i].frame_id, items[i].timestamp, items[i].host_ns,
+                               offset + i * m_header.frame_stride});
+        }
+        m_header.frame_count += count;
+
+        return count;
+    }
+
+    /**
+     * @brief 回写新增的索引与文件头，录制过程中应定期调用
+     *
+     * 先写索引后写帧数，文件中的帧数始终不超过已写入的索引；数据写入系统缓存即返回，不等待落盘。
+     */
+    bool sync() {
+        if (!isOpen()) return false;
+
+        if (m_synced_count < m_index.size()) {
+            uint64_t offset = m_header.index_offset + m_synced_count * sizeof(FrameSequenceIndexEntry);
+            size_t size = (m_index.size() - m_synced_count) * sizeof(FrameSequenceIndexEntry);
+            if (!writeAt(offset, m_index.data() + m_synced_count, size)) return false;
+        }
+        if (!writeAt(0, &m_header, sizeof(m_header))) return false;
+
+        m_synced_count = m_index.size();
+
+        return true;
+    }
+
+    /**
+     * @brief 回写索引与文件头，等待落盘后关闭
+     */
+    void close() {
+        if (!isOpen()) return;
+
+        sync();
+        flushToDisk();
+        closeFile();
+    }
+
+    bool isOpen() const {
+#ifdef _WIN32
+        return m_file_handle != INVALID_HANDLE_VALUE;
+#else
+        return m_fd >= 0;
+#endif
+    }
+
+    bool isFull() const {
+        return m_header.frame_count >= m_header.capacity;
+    }
+
+    uint64_t frameCount() const {
+        return m_header.frame_count;
+    }
+
+    uint64_t frameSize() const {
+        return m_header.frame_size;
+    }
+
+    const FrameSequenceHeader &header() const {
+        return m_header;
+    }
+
+private:
+#ifdef _WIN32
+    static constexpr size_t kMaxBatchBytes = 64 * 1024 * 1024;   // 暂存缓冲区上限
+
+    bool openFile(const std::string &path) {
+        m_file_handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                    CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        return m_file_handle != INVALID_HANDLE_VALUE;
+    }
+
+    void closeFile() {
+        if (m_file_handle != INVALID_HANDLE_VALUE) CloseHandle(m_file_handle);
+        m_file_handle = INVALID_HANDLE_VALUE;
+        m_staging.clear();
+        m_staging.shrink_to_fit();
+    }
+
+    bool preallocate(uint64_t size) {
+        LARGE_INTEGER end;
+        end.QuadPart = (LONGLONG) size;
+        if (!SetFilePointerEx(m_file_handle, end, nullptr, FILE_BEGIN) || !SetEndOfFile(m_file_handle)) return false;
+
+        // 需要 SE_MANAGE_VOLUME_NAME 权限，失败时写入时由系统补零，不影响正确性
+        SetFileValidData(m_file_handle, (LONGLONG) size);
+
+        return true;
+    }
+
+    bool writeAt(uint64_t offset, const void *data, size_t size) {
+        const char *p = static_cast<const char *>(data);
+
+        while (size > 0) {
+            OVERLAPPED overlapped;
+            std::memset(&overlapped, 0, sizeof(overlapped));
+            overlapped.Offset = (DWORD) (offset & 0xFFFFFFFFu);
+            overlapped.OffsetHigh = (DWORD) (offset >> 32);
+
+            DWORD chunk = (DWORD) std::min<size_t>(size, 1u << 30);
+            DWORD written = 0;
+            if (!WriteFile(m_file_handle, p, chunk, &written, &overlapped) || written == 0) return false;
+
+            p += written;
+            offset += written;
+            size -= written;
+        }
+
+        return true;
+    }
+
+    bool writeFrames(uint64_t offset, const FrameSequenceWriteItem *items, size_t count) {
+        size_t stride = (size_t) m_header.frame_stride;
+        size_t frame_size = (size_t) m_header.frame_size;
+        size_t batch = std::max<size_t>(1, kMaxBatchBytes / stride);
+
+        for (size_t begin = 0; begin < count; begin += batch) {
+            size_t n = std::min(batch, count - begin);
+            if (m_staging.size() < n * stride) m_staging.resize(n * stride);
+
+            // 帧间填充补零，SetFileValidData 生效时文件中的旧数据不会暴露
+            for (size_t i = 0; i < n; i++) {
+                uint8_t *dst = m_staging.data() + i * stride;
+                std::memcpy(dst, items[begin + i].data, frame_size);
+                std::memset(dst + frame_size, 0, stride - frame_size);
+            }
+
+            if (!writeAt(offset + begin * stride, m_staging.data(), n * stride)) return false;
+        }
+
+        return true;
+    }
+
+    void flushToDisk() {
+        FlushFileBuffers(m_file_handle);
+    }
+#else
+    bool openFile(const std::string &path) {
+        m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        return m_fd >= 0;
+    }
+
+    void closeFile() {
+        if (m_fd >= 0) ::close(m_fd);
+        m_fd = -1;
+    }
+
+    bool preallocate(uint64_t size) {
+        int rc = posix_fallocate(m_fd, 0, (off_t) size);
+        if (rc == 0) return true;
+        if (rc == ENOSPC) return false;
+
+        // 文件系统不支持预分配时退化为稀疏文件
+        std::cout << "Frame sequence file fallocate unsupported, using sparse file" << std::endl;
+        return ftruncate(m_fd, (off_t) size) == 0;
+    }
+
+    bool writeAt(uint64_t offset, const void *data, size_t size) {
+        struct iovec iov;
+        iov.iov_base = const_cast<void *>(data);
+        iov.iov_len = size;
+
+        return writeVector(offset, &iov, 1);
+    }
+
+    bool writeFrames(uint64_t offset, const FrameSequenceWriteItem *items, size_t count) {
+        static const uint8_t zeros[kFrameSequenceAlignment] = {};
+
+        size_t frame_size = (size_t) m_header.frame_size;
+        size_t padding = (size_t) (m_header.frame_stride - m_header.frame_size);
+
+        // 帧间填充指向全零页，使多帧在文件中连续，一次 pwritev 写完
+        m_iov.clear();
+        for (size_t i = 0; i < count; i++) {
+            m_iov.push_back({const_cast<void *>(items[i].data), frame_size});
+            if (padding > 0 && i + 1 < count) m_iov.push_back({const_cast<uint8_t *>(zeros), padding});
+        }
+
+        return writeVector(offset, m_iov.data(), m_iov.size());
+    }
+
+    bool writeVector(uint64_t offset, struct iovec *iov, size_t count) {
+        while (count > 0) {
+            int n = (int) std::min<size_t>(count, IOV_MAX);
+            ssize_t written = pwritev(m_fd, iov, n, (off_t) offset);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            if (written == 0) return false;
+            offset += (uint64_t) written;
+
+            // 跳过已写完的部分，处理部分写入
+            size_t remaining = (size_t) written;
+            while (count > 0 && remaining >= iov->iov_len) {
+                remaining -= iov->iov_len;
+                iov++;
+                count--;
+            }
+            if (count > 0) {
+                iov->iov_base = static_cast<uint8_t *>(iov->iov_base) + remaining;
+                iov->iov_len -= remaining;
+            }
+        }
+
+        return true;
+    }
+
+    void flushToDisk() {
+        fsync(m_fd);
+    }
+#endif
+
+private:
+#ifdef _WIN32
+    HANDLE m_file_handle;
+    std::vector<uint8_t> m_staging;
+#else
+    int m_fd;
+    std::vector<struct iovec> m_iov;
+#endif
+
+    FrameSequenceHeader m_header;
+    std::vector<FrameSequenceIndexEntry> m_index;
+    size_t m_synced_count;                   // 已回写到文件的索引条目数
+};
+
+
+#endif // FRAME_SEQUENCE_FILE_HPP
@@ -0,0 +1,290 @@
+#ifndef FRAME_SEQUENCE_READER_HPP
+#define FRAME_SEQUENCE_READER_HPP
+
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "opencv2/opencv.hpp"
+#include "frame_sequence_file.hpp"
+
+
+/**
+ * @brief 帧序列文件的内存映射读取器
+ *
+ * 整个文件只读映射到进程地址空间，frame() 返回直接指向映射内存的 cv::Mat（零拷贝），
+ * 在读取器关闭之前有效。顺序扫描时可调用 prefetch() 提示系统预读后续帧。
+ */
+class FrameSequenceReader {
+public:
+    FrameSequenceReader()
+            : m_data(nullptr),
+              m_size(0),
+              m_header(nullptr),
+              m_index(nullptr) {
+#ifdef _WIN32
+        m_file_handle = INVALID_HANDLE_VALUE;
+        m_mapping_handle = nullptr;
+#else
+        m_fd = -1;
+#endif
+    }
+
+    ~FrameSequenceReader() {
+        close();
+    }
+
+    FrameSequenceReader(const FrameSequenceReader &) = delete;
+    FrameSequenceReader &operator=(const FrameSequenceReader &) = delete;
+
+    bool open(const std::string &path) {
+        close();
+
+        if (!mapFile(path)) {
+            std::cout << "Frame sequence file map error: " << path << std::endl;
+            close();
+            return false;
+        }
+
+        if (m_size < sizeof(FrameSequenceHeader)) {
+            std::cout << "Frame sequence file too small: " << path << std::endl;
+            close();
+            return false;
+        }
+
+        m_header = reinterpret_cast<const FrameSequenceHeader *>(m_data);
+        if (!validate()) {
+            std::cout << "Frame sequence file invalid: " << path << std::endl;
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void close() {
+        unmapFile();
+
+        m_data = nullptr;
+        m_size = 0;
+        m_header = nullptr;
+        m_index = nullptr;
+    }
+
+    bool isOpen() const {
+        return m_header != nullptr;
+    }
+
+    uint64_t frameCount() const {
+        return m_header ? m_header->frame_count : 0;
+    }
+
+    int width() const {
+        return m_header ? m_header->width : 0;
+    }
+
+    int height() const {
+        return m_header ? m_header->height : 0;
+    }
+
+    const FrameSequenceHeader *header() const {
+        return m_header;
+    }
+
+    /**
+     * @param index - 须小于 frameCount()
+     */
+    const FrameSequenceIndexEntry &entry(uint64_t index) const {
+        return m_index[index];
+    }
+
+    const uint8_t *frameData(uint64_t index) const {
+        if (!m_header || index >= m_header->frame_count) return nullptr;
+
+        return m_data + m_index[index].offset;
+    }
+
+    /**
+     * @brief 按序号获取帧（零拷贝视图）
+     */
+    cv::Mat frame(uint64_t index) const {
+        const uint8_t *data = frameData(index);
+        if (!data) return cv::Mat();
+
+        return cv::Mat(m_header->height, m_header->width, m_header->cv_type,
+                       const_cast<uint8_t *>(data), (size_t) m_header->step);
+    }
+
+    /**
+     * @brief 查找主机接收时间不早于 host_ns 的第一帧
+     * @return 帧序号，超出范围时返回 frameCount()
+     */
+    uint64_t findByHostTime(uint64_t host_ns) const {
+        if (!m_header) return 0;
+
+        const FrameSequenceIndexEntry *end = m_index + m_header->frame_count;
+        const FrameSequenceIndexEntry *it = std::lower_bound(m_index, end, host_ns,
+            [](const FrameSequenceIndexEntry &e, uint64_t t) { return e.host_ns < t; });
+
+        return (uint64_t) (it - m_index);
+    }
+
+    /**
+     * @brief 查找 SDK 时间戳不早于 timestamp 的第一帧
+     * @return 帧序号，超出范围时返回 frameCount()
+     */
+    uint64_t findByTimestamp(uint64_t timestamp) const {
+        if (!m_header) return 0;
+
+        const FrameSequenceIndexEntry *end = m_index + m_header->frame_count;
+        const FrameSequenceIndexEntry *it = std::lower_bound(m_index, end, timestamp,
+            [](const FrameSequenceIndexEntry &e, uint64_t t) { return e.timestamp < t; });
+
+        return (uint64_t) (it - m_index);
+    }
+
+    /**
+     * @brief 提示系统异步预读 [index, index + count) 范围内的帧
+     */
+    void prefetch(uint64_t index, uint64_t count) const {
+        if (!m_header || index >= m_header->frame_count) return;
+
+        count = std::min(count, m_header->frame_count - index);
+        const uint8_t *begin = m_data + m_index[index].offset;
+        size_t length = (size_t) std::min<uint64_t>(count * m_header->frame_stride, m_size - m_index[index].offset);
+
+#ifdef _WIN32
+#if _WIN32_WINNT >= 0x0602
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = const_cast<uint8_t *>(begin);
+        range.NumberOfBytes = length;
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+        (void) begin;
+        (void) length;
+#endif
+#else
+        madvise(const_cast<uint8_t *>(begin), length, MADV_WILLNEED);
+#endif
+    }
+
+    /**
+     * @brief 提示系统整个文件将被顺序访问
+     */
+    void adviseSequential() const {
+#ifndef _WIN32
+        if (m_data) madvise(const_cast<uint8_t *>(m_data), m_size, MADV_SEQUENTIAL);
+#endif
+    }
+
+private:
+    /**
+     * @brief 校验文件头与全部索引条目，保证之后按索引访问不会越出映射范围
+     */
+    bool validate() {
+        const FrameSequenceHeader &h = *m_header;
+        uint64_t size = (uint64_t) m_size;
+
+        if (std::memcmp(h.magic, kFrameSequenceMagic, sizeof(kFrameSequenceMagic)) != 0 ||
+            h.version != kFrameSequenceVersion) {
+            return false;
+        }
+        if (h.width <= 0 || h.height <= 0 || h.step <= 0 ||
+            h.frame_size != (uint64_t) h.step * (uint64_t) h.height ||
+            h.frame_stride < h.frame_size || h.frame_count > h.capacity) {
+            return false;
+        }
+
+        // 以除法比较，避免损坏的字段使乘法溢出
+        if (h.index_offset > size || h.capacity > (size - h.index_offset) / sizeof(FrameSequenceIndexEntry) ||
+            h.data_offset > size || h.frame_size > size) {
+            return false;
+        }
+        if (h.frame_count > 0 && h.frame_count - 1 > (size - h.data_offset) / h.frame_stride) {
+            return false;
+        }
+
+        m_index = reinterpret_cast<const FrameSequenceIndexEntry *>(m_data + h.index_offset);
+        for (uint64_t i = 0; i < h.frame_count; i++) {
+            uint64_t offset = m_index[i].offset;
+            if (offset < h.data_offset || offset > size - h.frame_size) {
+                m_index = nullptr;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool mapFile(const std::string &path) {
+#ifdef _WIN32
+        m_file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_file_handle == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(m_file_handle, &file_size) || file_size.QuadPart == 0) return false;
+        m_size = (size_t) file_size.QuadPart;
+
+        m_mapping_handle = CreateFileMappingA(m_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping_handle == nullptr) return false;
+
+        m_data = static_cast<const uint8_t *>(MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+        return m_data != nullptr;
+#else
+        m_fd = ::open(path.c_str(), O_RDONLY);
+        if (m_fd < 0) return false;
+
+        struct stat st;
+        if (fstat(m_fd, &st) != 0 || st.st_size == 0) return false;
+        m_size = (size_t) st.st_size;
+
+        void *data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_fd, 0);
+        if (data == MAP_FAILED) return false;
+
+        m_data = static_cast<const uint8_t *>(data);
+        return true;
+#endif
+    }
+
+    void unmapFile() {
+#ifdef _WIN32
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping_handle) CloseHandle(m_mapping_handle);
+        if (m_file_handle != INVALID_HANDLE_VALUE) CloseHandle(m_file_handle);
+        m_mapping_handle = nullptr;
+        m_file_handle = INVALID_HANDLE_VALUE;
+#else
+        if (m_data) munmap(const_cast<uint8_t *>(m_data), m_size);
+        if (m_fd >= 0) ::close(m_fd);
+        m_fd = -1;
+#endif
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE m_file_handle;
+    HANDLE m_mapping_handle;
+#else
+    int m_fd;
+#endif
+
+    const uint8_t *m_data;
+    size_t m_size;
+    const FrameSequenceHeader *m_header;
+    const FrameSequenceIndexEntry *m_index;
+};
+
+
+#endif // FRAME_SEQUENCE_READER_HPP
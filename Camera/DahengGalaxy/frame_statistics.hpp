@@ -0,0 +1,152 @@
+#ifndef FRAME_STATISTICS_HPP
+#define FRAME_STATISTICS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "opencv2/opencv.hpp"
+
+
+/**
+ * @brief 单帧的灰度统计，随帧发布，所有消费者共享同一份结果
+ *
+ * 数值使用输出帧的原始单位（16 位帧为高位对齐的值），直方图统一为 256 级
+ * （16 位帧按高字节分级）。彩色帧只统计绿色通道。
+ */
+struct FrameStatistics {
+    static constexpr int kHistogramBins = 256;
+
+    bool valid = false;                  // 未开启统计时为 false
+    int min = 0;
+    int max = 0;
+    double mean = 0;
+    uint64_t pixel_count = 0;            // 参与统计的像素数（ROI 与采样之后）
+    uint64_t saturated_count = 0;        // 达到饱和值的像素数
+    uint32_t histogram[kHistogramBins] = {};
+    cv::Rect roi;                        // 计算时使用的统计区域与采样间隔，供消费者判断能否复用
+    int subsample = 0;
+
+    double saturatedFraction() const {
+        return pixel_count > 0 ? (double) saturated_count / (double) pixel_count : 0;
+    }
+};
+
+
+namespace frame_statistics_detail {
+
+// 交替写入四张直方图，避免相邻像素落在同一级时的写后读依赖
+template<typename T, int Shift>
+inline void accumulate(const cv::Mat &region, int channel, int step, int saturation_level, FrameStatistics &stats) {
+    uint32_t partial[4][FrameStatistics::kHistogramBins];
+    std::memset(partial, 0, sizeof(partial));
+
+    int channels = region.channels();
+    int stride = step * channels;
+    int min = INT32_MAX;
+    int max = 0;
+    uint64_t sum = 0;
+    uint64_t saturated = 0;
+    uint64_t count = 0;
+
+    for (int y = 0; y < region.rows; y += step) {
+        const T *p = region.ptr<T>(y) + channel;
+        int n = (region.cols + step - 1) / step;
+        int x = 0;
+
+        for (; x + 4 <= n; x += 4) {
+            int v0 = p[0], v1 = p[stride], v2 = p[2 * stride], v3 = p[3 * stride];
+            p += 4 * stride;
+
+            partial[0][v0 >> Shift]++;
+            partial[1][v1 >> Shift]++;
+            partial[2][v2 >> Shift]++;
+            partial[3][v3 >> Shift]++;
+
+            // 8 位帧的最值、均值与饱和数在最后由直方图精确得出，只有 16 位帧需要逐像素计算
+            if (Shift > 0) {
+                min = std::min(min, std::min(std::min(v0, v1), std::min(v2, v3)));
+                max = std::max(max, std::max(std::max(v0, v1), std::max(v2, v3)));
+                sum += (uint64_t) (v0 + v1) + (uint64_t) (v2 + v3);
+                saturated += (v0 >= saturation_level) + (v1 >= saturation_level) +
+                             (v2 >= saturation_level) + (v3 >= saturation_level);
+            }
+        }
+
+        for (; x < n; x++) {
+            int v = *p;
+            p += stride;
+
+            partial[0][v >> Shift]++;
+            if (Shift > 0) {
+                min = std::min(min, v);
+                max = std::max(max, v);
+                sum += (uint64_t) v;
+                saturated += v >= saturation_level;
+            }
+        }
+
+        count += (uint64_t) n;
+    }
+
+    for (int i = 0; i < FrameStatistics::kHistogramBins; i++) {
+        stats.histogram[i] = partial[0][i] + partial[1][i] + partial[2][i] + partial[3][i];
+    }
+    stats.pixel_count = count;
+    if (count == 0) return;
+
+    if (Shift == 0) {
+        min = INT32_MAX;
+        for (int i = 0; i < FrameStatistics::kHistogramBins; i++) {
+            if (stats.histogram[i] == 0) continue;
+
+            min = std::min(min, i);
+            max = i;
+            sum += (uint64_t) stats.histogram[i] * (uint64_t) i;
+            if (i >= saturation_level) saturated += stats.histogram[i];
+        }
+    }
+
+    stats.min = min;
+    stats.max = max;
+    stats.mean = (double) sum / (double) count;
+    stats.saturated_count = saturated;
+}
+
+}  // namespace frame_statistics_detail
+
+
+/**
+ * @brief 一次遍历计算最小值、最大值、均值、直方图与饱和像素数
+ * @param roi - 统计区域（帧坐标），为空时使用整帧，超出图像的部分被裁掉
+ * @param subsample - 行列采样间隔，1 表示逐像素统计
+ * @param saturation_level - 饱和值，见 pixelFormatOutputMaxValue()
+ */
+inline void computeFrameStatistics(const cv::Mat &image, const cv::Rect &roi, int subsample, int saturation_level,
+                                   FrameStatistics &stats) {
+    stats = FrameStatistics();
+    stats.roi = roi;
+    stats.subsample = std::max(subsample, 1);
+    if (image.empty()) return;
+
+    cv::Mat region = image;
+    if (roi.area() > 0) {
+        cv::Rect clipped = roi & cv::Rect(0, 0, image.cols, image.rows);
+        if (clipped.area() <= 0) return;
+        region = image(clipped);
+    }
+
+    int step = stats.subsample;
+    int channel = region.channels() == 3 ? 1 : 0;
+
+    if (region.depth() == CV_16U) {
+        frame_statistics_detail::accumulate<uint16_t, 8>(region, channel, step, saturation_level, stats);
+    } else {
+        frame_statistics_detail::accumulate<uint8_t, 0>(region, channel, step, saturation_level, stats);
+    }
+
+    stats.valid = true;
+}
+
+
+#endif // FRAME_STATISTICS_HPP
@@ -0,0 +1,182 @@
+#ifndef FRAME_WORKER_HPP
+#define FRAME_WORKER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+#include "frame_pool.hpp"
+#include "spsc_queue.hpp"
+
+
+/**
+ * @brief 单线程帧处理器：有界无锁队列 + 一个工作线程
+ *
+ * 生产者（通常为采集或发布线程）通过 push() 投递帧句柄，不等待处理；工作线程按顺序对每一帧调用处理函数。
+ * 队列满时按 OverflowPolicy 丢帧：DropNewest（默认）使用无锁队列并拒绝新帧；DropOldest 丢弃队列中最旧的帧，
+ * 工作线程总是处理最新的帧，入队与出队各短暂持一次锁。有帧被丢弃或未在运行时 push() 返回 false，由调用方决定是否计数。
+ *
+ * start() / stop() 可以在生产者仍在调用 push() 时调用：stop() 先关闭入口，再等待正在进行的 push() 返回，
+ * 之后才重置队列，队列不会在入队期间被重新分配。
+ */
+class FrameWorker {
+public:
+    using Handler = std::function<void(const FrameRef &frame)>;
+
+    // 队列满时的处理方式
+    enum class OverflowPolicy {
+        DropNewest,   // 拒绝新帧，保持已排队的帧（按顺序处理）
+        DropOldest,   // 丢弃最旧的帧，保证最新的帧进入队列（实时处理）
+    };
+
+    FrameWorker()
+            : m_running(false),
+              m_pushing(0),
+              m_stop_flag(false),
+              m_capacity(4),
+              m_policy(OverflowPolicy::DropNewest) {}
+
+    ~FrameWorker() {
+        stop();
+    }
+
+    FrameWorker(const FrameWorker &) = delete;
+    FrameWorker &operator=(const FrameWorker &) = delete;
+
+    /**
+     * @param handler - 在工作线程中对每一帧调用
+     * @param queue_capacity - 等待处理的最大帧数
+     */
+    void start(Handler handler, size_t queue_capacity = 4, OverflowPolicy policy = OverflowPolicy::DropNewest) {
+        stop();
+
+        m_handler = std::move(handler);
+        m_capacity = std::max<size_t>(queue_capacity, 1);
+        m_policy = policy;
+        m_queue.reset(policy == OverflowPolicy::DropNewest ? m_capacity : 1);
+        m_pending.clear();
+        m_stop_flag = false;
+        m_thread = std::thread(&FrameWorker::workLoop, this);
+        m_running.store(true, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief 处理完队列中剩余的帧后退出工作线程，不能在处理函数中调用
+     */
+    void stop() {
+        // 关闭入口并等待正在入队的生产者离开，之后队列只由本线程与工作线程访问
+        m_running.store(false, std::memory_order_seq_cst);
+        while (m_pushing.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+
+        if (!m_thread.joinable()) return;
+
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_stop_flag = true;
+        }
+        m_cond.notify_all();
+        m_thread.join();
+    }
+
+    bool isRunning() const {
+        return m_running;
+    }
+
+    /**
+     * @brief 只能有一个生产者线程
+     * @return 有帧被丢弃（DropNewest 为本帧，DropOldest 为最旧的帧）或未在运行时返回 false
+     */
+    bool push(const FrameRef &frame) {
+        // 先登记再检查入口，与 stop() 的先关闭入口再等待登记清零配对，二者不会同时错过对方
+        m_pushing.fetch_add(1, std::memory_order_seq_cst);
+        bool running = m_running.load(std::memory_order_seq_cst);
+        bool drop_oldest = running && m_policy == OverflowPolicy::DropOldest;  // 离开登记后不再读取成员
+        bool queued = false;
+        bool ok = false;
+        FrameRef evicted;  // 在锁外归还帧池
+        if (drop_oldest) {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            ok = m_pending.size() < m_capacity;
+            if (!ok) {
+                evicted = std::move(m_pending.front());
+                m_pending.pop_front();
+            }
+            m_pending.push_back(frame);
+            queued = true;
+        } else if (running) {
+            ok = queued = m_queue.tryPush(frame);
+        }
+        m_pushing.fetch_sub(1, std::memory_order_seq_cst);
+        if (!queued) return false;
+
+        // 空临界区保证工作线程不会错过唤醒，只在入队后短暂持锁
+        if (!drop_oldest) {
+            std::lock_guard<std::mutex> locker(m_mutex);
+        }
+        m_cond.notify_one();
+
+        return ok;
+    }
+
+private:
+    void workLoop() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> locker(m_mutex);
+                m_cond.wait(locker, [this]() {
+                    return m_stop_flag || !m_queue.empty() || !m_pending.empty();
+                });
+            }
+
+            FrameRef frame;
+            while (pop(frame)) {
+                m_handler(frame);
+                frame.reset();  // 归还帧池
+            }
+
+            if (m_stop_flag && isEmpty()) break;
+        }
+    }
+
+    bool pop(FrameRef &frame) {
+        if (m_policy == OverflowPolicy::DropNewest) return m_queue.tryPop(frame);
+
+        std::lock_guard<std::mutex> locker(m_mutex);
+        if (m_pending.empty()) return false;
+
+        frame = std::move(m_pending.front());
+        m_pending.pop_front();
+
+        return true;
+    }
+
+    bool isEmpty() {
+        if (m_policy == OverflowPolicy::DropNewest) return m_queue.empty();
+
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_pending.empty();
+    }
+
+private:
+    Handler m_handler;
+    SpscQueue<FrameRef> m_queue;             // DropNewest
+    std::deque<FrameRef> m_pending;          // DropOldest，由 m_mutex 保护
+
+    std::atomic<bool> m_running;             // 是否接收新帧
+    std::atomic<int> m_pushing;              // 正在 push() 中的生产者数
+    std::atomic<bool> m_stop_flag;
+    size_t m_capacity;
+    OverflowPolicy m_policy;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::thread m_thread;
+};
+
+
+#endif // FRAME_WORKER_HPP
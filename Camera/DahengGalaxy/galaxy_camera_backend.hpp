@@ -0,0 +1,623 @@
+#ifndef GALAXY_CAMERA_BACKEND_HPP
+#define GALAXY_CAMERA_BACKEND_HPP
+
+#include <iostream>
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "GalaxyIncludes.h"
+#include "camera_backend.hpp"
+
+
+/**
+ * @brief 大恒 Galaxy SDK 相机后端
+ */
+class GalaxyCameraBackend : public ICameraBackend {
+public:
+    /**
+     * @param serial_number - 设备序列号，为空时打开枚举到的第一台设备
+     */
+    explicit GalaxyCameraBackend(std::string serial_number = "")
+            : m_serial_number(std::move(serial_number)),
+              m_pCaptureEventHandler(nullptr),
+              m_bIsOpen(false),
+              m_bIsSnap(false) {
+        cameraInit();
+    }
+
+    ~GalaxyCameraBackend() {
+        if (m_bIsOpen || m_bIsSnap) {
+            close();
+        }
+
+        if (m_pCaptureEventHandler != nullptr) {
+            delete m_pCaptureEventHandler;
+            m_pCaptureEventHandler = nullptr;
+        }
+    }
+
+    /**
+     * @brief 枚举当前连接的设备序列号
+     *
+     * 枚举串行进行；枚举到的设备在之后的首次打开时不再重复枚举，多台相机可先枚举一次再并行打开。
+     */
+    static std::vector<std::string> enumerateDevices(uint32_t timeout_ms = 1000) {
+        std::lock_guard<std::mutex> locker(enumerationMutex());
+
+        std::vector<std::string> serial_numbers;
+
+        try {
+            IGXFactory::GetInstance().Init();
+
+            GxIAPICPP::gxdeviceinfo_vector vectorDeviceInfo;
+            IGXFactory::GetInstance().UpdateDeviceList(timeout_ms, vectorDeviceInfo);
+            for (size_t i = 0; i < vectorDeviceInfo.size(); i++) {
+                serial_numbers.emplace_back(vectorDeviceInfo[i].GetSN().c_str());
+            }
+        } catch (CGalaxyException) {
+            std::cout << "Enumerate device galaxy error!" << std::endl;
+        }
+
+        enumeratedDevices() = serial_numbers;
+
+        return serial_numbers;
+    }
+
+    bool open() override {
+        openDevice();
+
+        return m_bIsOpen;
+    }
+
+    void close() override {
+        closeDevice();
+    }
+
+    bool start(const FrameCallback &callback) override {
+        m_frame_callback = callback;
+
+        startSnap();
+
+        return m_bIsSnap;
+    }
+
+    void stop() override {
+        stopSnap();
+    }
+
+    bool isOpen() const override {
+        return m_bIsOpen;
+    }
+
+    bool isGrabbing() const override {
+        return m_bIsSnap;
+    }
+
+    std::string serialNumber() const override {
+        return m_serial_number;
+    }
+
+    void enterTriggerMode() override {
+        enumFeature("TriggerSelector")->SetValue("FrameStart");
+        enumFeature("TriggerSource")->SetValue("Software");
+        enumFeature("TriggerMode")->SetValue("On");
+    }
+
+    void exitTriggerMode() override {
+        enumFeature("TriggerSelector")->SetValue("FrameStart");
+        enumFeature("TriggerMode")->SetValue("Off");
+    }
+
+    void softwareTrigger() override {
+        commandFeature("TriggerSoftware")->Execute();
+    }
+
+    int64_t getIntFeature(const std::string &name) override {
+        return intFeature(name)->GetValue();
+    }
+
+    void setIntFeature(const std::string &name, int64_t value) override {
+        intFeature(name)->SetValue(value);
+    }
+
+    double getFloatFeature(const std::string &name) override {
+        return floatFeature(name)->GetValue();
+    }
+
+    void setFloatFeature(const std::string &name, double value) override {
+        floatFeature(name)->SetValue(value);
+    }
+
+    std::string getEnumFeature(const std::string &name) override {
+        return enumFeature(name)->GetValue().c_str();
+    }
+
+    void setEnumFeature(const std::string &name, const std::string &value) override {
+        enumFeature(name)->SetValue(value.c_str());
+    }
+
+    void executeCommand(const std::string &name) override {
+        commandFeature(name)->Execute();
+    }
+
+    void flushQueue() override {
+        if (!m_bIsSnap) return;
+
+        try {
+            m_objStreamPtr->FlushQueue();
+        } catch (CGalaxyException) {
+            std::cout << "Flush stream queue error!" << std::endl;
+        }
+    }
+
+    bool setStreamBuffering(const StreamBufferSettings &settings) override {
+        m_stream_buffering = settings;
+        return true;
+    }
+
+    bool hasFeature(const std::string &name) override {
+        std::lock_guard<std::mutex> locker(m_feature_mutex);
+        if (m_objFeatureControlPtr.IsNull()) return false;
+
+        auto it = m_implemented.find(name);
+        if (it != m_implemented.end()) return it->second;
+
+        bool implemented = m_objFeatureControlPtr->IsImplemented(name.c_str());
+        m_implemented.emplace(name, implemented);
+
+        return implemented;
+    }
+
+    bool getIntFeatureRange(const std::string &name, int64_t &min, int64_t &max, int64_t &inc) override {
+        if (m_objFeatureControlPtr.IsNull()) return false;
+
+        CIntFeaturePointer feature = intFeature(name);
+        min = feature->GetMin();
+        max = feature->GetMax();
+        inc = feature->GetInc();
+
+        return true;
+    }
+
+private:
+    // 用户继承采集事件处理类
+    class CSampleCaptureEventHandler : public ICaptureEventHandler {
+    public:
+        void DoOnImageCaptured(CImageDataPointer &objImageDataPointer, void *pUserParam) {
+            GalaxyCameraBackend *backend = static_cast<GalaxyCameraBackend *>(pUserParam);
+
+            try {
+                RawFrame frame;
+                frame.data = objImageDataPointer->GetBuffer();
+                frame.size = objImageDataPointer->GetPayloadSize();
+                frame.width = (int) objImageDataPointer->GetWidth();
+                frame.height = (int) objImageDataPointer->GetHeight();
+                frame.frame_id = objImageDataPointer->GetFrameID();
+                frame.timestamp = objImageDataPointer->GetTimeStamp();
+
+                if (backend->m_frame_callback) backend->m_frame_callback(frame);
+            } catch (CGalaxyException) {
+                // do noting
+            }
+        }
+    };
+
+    /**
+     * @brief 按名称查找特征节点，首次查找后缓存，避免每次读写都在 GenICam 节点表中按字符串查找
+     *
+     * 节点句柄在设备关闭前一直有效；只在查找时持锁，读写节点本身不持锁。设备未打开时抛出 std::runtime_error。
+     */
+    template<typename Pointer, typename Resolve>
+    Pointer cachedFeature(std::unordered_map<std::string, Pointer> &cache, const std::string &name, Resolve resolve) {
+        std::lock_guard<std::mutex> locker(m_feature_mutex);
+        if (m_objFeatureControlPtr.IsNull()) throw std::runtime_error("Galaxy device not open: " + name);
+
+        auto it = cache.find(name);
+        if (it != cache.end()) return it->second;
+
+        Pointer feature = resolve(name.c_str());
+        cache.emplace(name, feature);
+
+        return feature;
+    }
+
+    CIntFeaturePointer intFeature(const std::string &name) {
+        return cachedFeature(m_int_features, name, [this](const char *n) {
+            return m_objFeatureControlPtr->GetIntFeature(n);
+        });
+    }
+
+    CFloatFeaturePointer floatFeature(const std::string &name) {
+        // 常用特征直接使用打开时解析的句柄，不加锁也不查表
+        if (name == "ExposureTime" && !m_exposure_time_feature.IsNull()) return m_exposure_time_feature;
+        if (name == "Gain" && !m_gain_feature.IsNull()) return m_gain_feature;
+
+        return cachedFeature(m_float_features, name, [this](const char *n) {
+            return m_objFeatureControlPtr->GetFloatFeature(n);
+        });
+    }
+
+    CEnumFeaturePointer enumFeature(const std::string &name) {
+        if (name == "TriggerMode" && !m_trigger_mode_feature.IsNull()) return m_trigger_mode_feature;
+        if (name == "TriggerSource" && !m_trigger_source_feature.IsNull()) return m_trigger_source_feature;
+        if (name == "TriggerSelector" && !m_trigger_selector_feature.IsNull()) return m_trigger_selector_feature;
+
+        return cachedFeature(m_enum_features, name, [this](const char *n) {
+            return m_objFeatureControlPtr->GetEnumFeature(n);
+        });
+    }
+
+    CCommandFeaturePointer commandFeature(const std::string &name) {
+        if (name == "TriggerSoftware" && !m_trigger_software_feature.IsNull()) return m_trigger_software_feature;
+
+        return cachedFeature(m_command_features, name, [this](const char *n) {
+            return m_objFeatureControlPtr->GetCommandFeature(n);
+        });
+    }
+
+    /**
+     * @brief 打开设备时预先解析常用特征，之后的读写不再查找
+     */
+    void resolveFeatures() {
+        CameraParameterSet parameters = CameraParameterSet::standardParameters();
+        parameters.setEnum("AcquisitionMode", "");
+        parameters.setEnum("TriggerSelector", "");
+        parameters.setEnum("PixelFormat", "");
+        for (const char *name : {"Width", "Height", "OffsetX", "OffsetY", "WidthMax", "HeightMax"}) {
+            parameters.setInt(name, 0);
+        }
+        for (const char *name : {"TriggerSoftware", "AcquisitionStart", "AcquisitionStop"}) {
+            parameters.execute(name);
+        }
+
+        for (const CameraParameterSet::Entry &entry : parameters.entries()) {
+            try {
+                if (!hasFeature(entry.name)) continue;
+
+                switch (entry.type) {
+                    case CameraParameterSet::Type::Int: intFeature(entry.name); break;
+                    case CameraParameterSet::Type::Float: floatFeature(entry.name); break;
+                    case CameraParameterSet::Type::Enum: enumFeature(entry.name); break;
+                    case CameraParameterSet::Type::Command: commandFeature(entry.name); break;
+                }
+            } catch (CGalaxyException) {
+                // 类型不符等，首次使用时再报错
+            }
+        }
+
+        // 曝光、增益与触发在采集过程中频繁读写，从缓存中取出放到成员句柄中
+        std::lock_guard<std::mutex> locker(m_feature_mutex);
+        auto take = [](auto &cache, const char *name, auto &handle) {
+            auto it = cache.find(name);
+            if (it != cache.end()) handle = it->second;
+        };
+        take(m_float_features, "ExposureTime", m_exposure_time_feature);
+        take(m_float_features, "Gain", m_gain_feature);
+        take(m_enum_features, "TriggerMode", m_trigger_mode_feature);
+        take(m_enum_features, "TriggerSource", m_trigger_source_feature);
+        take(m_enum_features, "TriggerSelector", m_trigger_selector_feature);
+        take(m_command_features, "TriggerSoftware", m_trigger_software_feature);
+    }
+
+    void clearFeatureCache() {
+        std::lock_guard<std::mutex> locker(m_feature_mutex);
+        m_exposure_time_feature = CFloatFeaturePointer();
+        m_gain_feature = CFloatFeaturePointer();
+        m_trigger_mode_feature = CEnumFeaturePointer();
+        m_trigger_source_feature = CEnumFeaturePointer();
+        m_trigger_selector_feature = CEnumFeaturePointer();
+        m_trigger_software_feature = CCommandFeaturePointer();
+        m_int_features.clear();
+        m_float_features.clear();
+        m_enum_features.clear();
+        m_command_features.clear();
+        m_implemented.clear();
+    }
+
+    /**
+     * @return 全部参数写入成功时返回 true，否则打印写入失败的特征名
+     */
+    bool paramInit() {
+        CameraParameterSet parameters;
+        parameters.setEnum("AcquisitionMode", "Continuous")  // 设置 采集模式 为 连续采集
+                .setEnum("TriggerMode", "Off")               // 设置 触发模式 为 关
+                .setFloat("ExposureTime", 10000)             // 设置 初始曝光时间
+                .setFloat("Gain", 0);                        // 设置 初始曝光增益
+
+        std::vector<std::string> failed;
+        if (!applyParameters(parameters, &failed)) {
+            std::cout << "Init camera parameters error:";
+            for (const std::string &name : failed) {
+                std::cout << " " << name;
+            }
+            std::cout << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    void openDevice() {
+        // TODO: Add your control notification handler code here
+        bool bIsDeviceOpen = false;  // 设备开启标志
+        bool bIsStreamOpen = false;  // 流开启标志
+
+        try {
+            // 枚举设备，已由 enumerateDevices() 枚举到的设备不再重复枚举
+            if (m_serial_number.empty() || !takeEnumeratedDevice(m_serial_number)) {
+                std::vector<std::string> serial_numbers = enumerateDevices();
+                if (serial_numbers.empty()) {
+                    std::cout << "Device not found!" << std::endl;
+                    return;
+                }
+
+                // 未指定序列号时打开第一台设备
+                if (m_serial_number.empty()) {
+                    m_serial_number = serial_numbers[0];
+                }
+                takeEnumeratedDevice(m_serial_number);
+            }
+
+            // 打开设备
+            m_objDevicePtr = IGXFactory::GetInstance().OpenDeviceBySN(m_serial_number.c_str(), GX_ACCESS_EXCLUSIVE);
+            m_objFeatureControlPtr = m_objDevicePtr->GetRemoteFeatureControl();
+            clearFeatureCache();
+            bIsDeviceOpen = true;
+
+            // 获取流通道个数
+            uint32_t nStreamCount = m_objDevicePtr->GetStreamCount();
+            if (nStreamCount <= 0) {
+                std::cout << "Device stream not found!" << std::endl;
+                abortOpen(bIsStreamOpen, bIsDeviceOpen);
+                return;
+            }
+
+            // 打开流
+            m_objStreamPtr = m_objDevicePtr->OpenStream(0);
+            m_objStreamFeatureControlPtr = m_objStreamPtr->GetFeatureControl();
+            bIsStreamOpen = true;
+
+            // 建议用户在打开网络相机之后，根据当前网络环境设置相机的流通道包长值，
+            // 以提高网络相机的采集性能,设置方法参考以下代码。
+            GX_DEVICE_CLASS_LIST objDeviceClass = m_objDevicePtr->GetDeviceInfo().GetDeviceClass();
+            if (GX_DEVICE_CLASS_GEV == objDeviceClass) {
+                // 判断设备是否支持流通道数据包功能
+                if (true == m_objFeatureControlPtr->IsImplemented("GevSCPSPacketSize")) {
+                    // 获取当前网络环境的最优包长值
+                    int nPacketSize = m_objStreamPtr->GetOptimalPacketSize();
+                    // 将最优包长值设置为当前设备的流通道包长值
+                    m_objFeatureControlPtr->GetIntFeature("GevSCPSPacketSize")->SetValue(nPacketSize);
+                }
+            }
+
+            // 解析常用特征节点并初始化相机参数
+            resolveFeatures();
+            if (!paramInit()) {
+                abortOpen(bIsStreamOpen, bIsDeviceOpen);
+                return;
+            }
+
+            m_bIsOpen = true;
+        } catch (CGalaxyException) {
+            std::cout << "Open device galaxy error!" << std::endl;
+
+            abortOpen(bIsStreamOpen, bIsDeviceOpen);
+
+            return;
+        } catch (std::exception) {
+            std::cout << "Open device std error!" << std::endl;
+
+            abortOpen(bIsStreamOpen, bIsDeviceOpen);
+
+            return;
+        }
+    }
+
+    /**
+     * @brief 打开失败时关闭已打开的流与设备，并清除特征控制器，之后的特征访问按未打开处理
+     */
+    void abortOpen(bool stream_open, bool device_open) {
+        try {
+            if (stream_open) {
+                m_objStreamPtr->Close();
+            }
+
+            if (device_open) {
+                m_objDevicePtr->Close();
+            }
+        } catch (CGalaxyException) {
+            // do noting
+        }
+
+        clearFeatureCache();
+        m_objFeatureControlPtr = CGXFeatureControlPointer();
+    }
+
+    void startSnap() {
+        // TODO: Add your control notification handler code here
+        if (!m_bIsOpen || m_bIsSnap) return;
+
+        try {
+            try {
+                // 设置 Buffer 处理模式
+                const char *mode = "OldestFirst";
+                switch (m_stream_buffering.mode) {
+                    case StreamBufferSettings::Mode::OldestFirst: mode = "OldestFirst"; break;
+                    case StreamBufferSettings::Mode::OldestFirstOverwrite: mode = "OldestFirstOverwrite"; break;
+                    case StreamBufferSettings::Mode::NewestOnly: mode = "NewestOnly"; break;
+                }
+                m_objStreamFeatureControlPtr->GetEnumFeature("StreamBufferHandlingMode")->SetValue(mode);
+            } catch (...) {
+                std::cout << "Set stream buffer handling mode error!" << std::endl;
+            }
+
+            // 设置采集缓冲数，须在开启流层通道之前
+            if (m_stream_buffering.buffer_count > 0) {
+                try {
+                    m_objStreamPtr->SetAcqusitionBufferNumber(m_stream_buffering.buffer_count);
+                } catch (...) {
+                    std::cout << "Set acquisition buffer number error!" << std::endl;
+                }
+            }
+
+            // 注册回调函数
+            m_objStreamPtr->RegisterCaptureCallback(m_pCaptureEventHandler, this);
+
+            // 开启流层通道
+            m_objStreamPtr->StartGrab();
+
+            // 发送开采命令
+            commandFeature("AcquisitionStart")->Execute();
+
+            m_bIsSnap = true;
+        } catch (CGalaxyException) {
+            std::cout << "Open device galaxy error!" << std::endl;
+
+            return;
+        } catch (std::exception) {
+            std::cout << "Open device std error!" << std::endl;
+
+            return;
+        }
+    }
+
+    void stopSnap() {
+        // TODO: Add your control notification handler code here
+        if (!m_bIsSnap) return;
+
+        try {
+            // 发送停采命令
+            commandFeature("AcquisitionStop")->Execute();
+
+            // 关闭流层通道
+            m_objStreamPtr->StopGrab();
+
+            // 注销采集回调
+            m_objStreamPtr->UnregisterCaptureCallback();
+
+            m_bIsSnap = false;
+        } catch (CGalaxyException) {
+            std::cout << "Open device galaxy error!" << std::endl;
+
+            return;
+        } catch (std::exception) {
+            std::cout << "Open device std error!" << std::endl;
+
+            return;
+        }
+    }
+
+    void closeDevice() {
+        // TODO: Add your control notification handler code here
+        try {
+            // 判断是否已停止采集
+            if (m_bIsSnap) {
+                // 发送停采命令
+                commandFeature("AcquisitionStop")->Execute();
+
+                // 关闭流层采集
+                m_objStreamPtr->StopGrab();
+
+                // 注销采集回调
+                m_objStreamPtr->UnregisterCaptureCallback();
+
+                m_bIsSnap = false;
+            }
+        } catch (CGalaxyException) {
+            // do noting
+        }
+
+        if (!m_bIsOpen) return;
+
+        try {
+            // 关闭流对象
+            m_objStreamPtr->Close();
+        } catch (CGalaxyException) {
+            // do noting
+        }
+
+        try {
+            // 关闭设备
+            m_objDevicePtr->Close();
+        } catch (CGalaxyException) {
+            //do noting
+        }
+
+        clearFeatureCache();
+        m_objFeatureControlPtr = CGXFeatureControlPointer();
+        m_bIsOpen = false;
+    }
+
+    // 保护 UpdateDeviceList 与枚举结果，SDK 的设备列表为进程全局
+    static std::mutex &enumerationMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    // 最近一次枚举到、尚未被打开的设备
+    static std::vector<std::string> &enumeratedDevices() {
+        static std::vector<std::string> serial_numbers;
+        return serial_numbers;
+    }
+
+    /**
+     * @brief 从枚举结果中取出该设备，每次枚举只免去一次打开前的枚举，重新打开时仍会重新枚举
+     */
+    static bool takeEnumeratedDevice(const std::string &serial_number) {
+        std::lock_guard<std::mutex> locker(enumerationMutex());
+
+        std::vector<std::string> &devices = enumeratedDevices();
+        auto it = std::find(devices.begin(), devices.end(), serial_number);
+        if (it == devices.end()) return false;
+
+        devices.erase(it);
+        return true;
+    }
+
+    void cameraInit() {
+        try {
+            // 初始化库
+            IGXFactory::GetInstance().Init();
+
+            m_pCaptureEventHandler = new CSampleCaptureEventHandler();
+        } catch (...) {}
+    }
+
+private:
+    std::string m_serial_number;
+
+    CGXDevicePointer            m_objDevicePtr;                // 设备句柄
+    CGXFeatureControlPointer    m_objFeatureControlPtr;        // 设备控制器对象
+    CGXStreamPointer            m_objStreamPtr;                // 流对象
+    CGXFeatureControlPointer    m_objStreamFeatureControlPtr;  // 流层控制器对象
+    CSampleCaptureEventHandler *m_pCaptureEventHandler;        // 采集回调对象
+
+    std::mutex m_feature_mutex;                                // 保护特征节点缓存
+    std::unordered_map<std::string, CIntFeaturePointer> m_int_features;
+    std::unordered_map<std::string, CFloatFeaturePointer> m_float_features;
+    std::unordered_map<std::string, CEnumFeaturePointer> m_enum_features;
+    std::unordered_map<std::string, CCommandFeaturePointer> m_command_features;
+    std::unordered_map<std::string, bool> m_implemented;
+
+    // 常用特征的句柄，只在打开与关闭设备时写入（与 m_objFeatureControlPtr 相同），读写时不加锁
+    CFloatFeaturePointer m_exposure_time_feature;
+    CFloatFeaturePointer m_gain_feature;
+    CEnumFeaturePointer m_trigger_mode_feature;
+    CEnumFeaturePointer m_trigger_source_feature;
+    CEnumFeaturePointer m_trigger_selector_feature;
+    CCommandFeaturePointer m_trigger_software_feature;
+
+    FrameCallback m_frame_callback;
+    StreamBufferSettings m_stream_buffering;
+
+    bool m_bIsOpen;
+    bool m_bIsSnap;
+};
+
+
+#endif // GALAXY_CAMERA_BACKEND_HPP
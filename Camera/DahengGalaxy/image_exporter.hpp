@@ -0,0 +1,455 @@
+#ifndef IMAGE_EXPORTER_HPP
+#define IMAGE_EXPORTER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "opencv2/opencv.hpp"
+#include "frame_metrics.hpp"
+#include "frame_pool.hpp"
+
+
+/**
+ * @brief 后台图像导出服务
+ *
+ * 调用方只把图像放入有界队列即返回，编码（PNG / TIFF / JPEG）与写盘在线程池中并行进行。
+ * 先写入同目录下的临时文件并落盘，再重命名为目标文件，其它程序与掉电后都不会看到写了一半的文件。
+ *
+ * 提交帧时会拷贝图像，不占用帧池；队列容量即为导出占用的最大额外内存（帧数），被拒绝的图像不会拷贝。
+ */
+class ImageExporter {
+public:
+    enum class Format {
+        Auto,    // 按文件扩展名
+        Png,
+        Tiff,
+        Jpeg,
+    };
+
+    // 队列满时的处理方式
+    enum class SpillPolicy {
+        DropNewest,   // 拒绝新图像
+        DropOldest,   // 丢弃队列中最旧的图像
+        Block,        // 阻塞提交方直到有空位
+    };
+
+    struct Policy {
+        Format format = Format::Auto;
+        int png_compression = 1;     // 0-9，产线上优先编码速度
+        int jpeg_quality = 95;       // 0-100
+        bool tiff_lzw = false;       // TIFF 使用 LZW 压缩，否则不压缩
+        SpillPolicy spill = SpillPolicy::DropNewest;
+    };
+
+    struct Stats {
+        uint64_t submitted = 0;            // 进入队列的图像数
+        uint64_t written = 0;              // 成功写入的图像数
+        uint64_t dropped = 0;              // 队列满被丢弃的图像数
+        uint64_t failed = 0;               // 编码或写入失败的图像数
+        size_t queue_depth = 0;
+        size_t max_queue_depth = 0;
+        size_t queue_capacity = 0;
+        int workers = 0;
+        LatencyHistogram::Summary encode;  // 单张编码耗时
+        LatencyHistogram::Summary write;   // 单张写盘（含重命名）耗时
+    };
+
+    // 在工作线程中调用
+    using DoneCallback = std::function<void(const std::string &path, bool ok)>;
+
+    ImageExporter()
+            : m_running(false),
+              m_stop_flag(false),
+              m_capacity(16),
+              m_max_queue_depth(0),
+              m_busy(0),
+              m_submitted(0),
+              m_written(0),
+              m_dropped(0),
+              m_failed(0) {}
+
+    ~ImageExporter() {
+        stop();
+    }
+
+    ImageExporter(const ImageExporter &) = delete;
+    ImageExporter &operator=(const ImageExporter &) = delete;
+
+    /**
+     * @param workers - 编码线程数，0 表示按 CPU 核数的一半
+     * @param queue_capacity - 等待编码的最大图像数
+     */
+    void start(int workers = 0, size_t queue_capacity = 16) {
+        std::lock_guard<std::mutex> lifecycle(m_lifecycle_mutex);
+
+        stopThreads();
+        startThreads(workers, queue_capacity);
+    }
+
+    /**
+     * @brief 未启动时以给定参数启动，已启动时不做任何事；可在多个线程中同时调用
+     * @return 本次调用启动了线程池时返回 true
+     */
+    bool ensureStarted(int workers = 0, size_t queue_capacity = 16) {
+        std::lock_guard<std::mutex> lifecycle(m_lifecycle_mutex);
+
+        if (!m_threads.empty()) return false;
+
+        startThreads(workers, queue_capacity);
+        return true;
+    }
+
+    /**
+     * @brief 写完队列中剩余的图像后退出线程池
+     */
+    void stop() {
+        std::lock_guard<std::mutex> lifecycle(m_lifecycle_mutex);
+
+        stopThreads();
+    }
+
+    bool isRunning() const {
+        return m_running;
+    }
+
+    void setPolicy(const Policy &policy) {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_policy = policy;
+    }
+
+    Policy getPolicy() {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_policy;
+    }
+
+    void setDoneCallback(DoneCallback callback) {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_done_callback = std::move(callback);
+    }
+
+    /**
+     * @brief 提交一帧（拷贝图像，RGB 帧按 RGB 顺序保存）
+     * @return 被丢弃或服务未启动时返回 false
+     */
+    bool submit(const FrameRef &frame, const std::string &path) {
+        if (!frame) return false;
+
+        return enqueue(frame.mat(), frame->cv_type == CV_8UC3, path);
+    }
+
+    /**
+     * @brief 提交一张图像（拷贝），三通道图像按 OpenCV 的 BGR 顺序解释
+     */
+    bool submit(const cv::Mat &image, const std::string &path) {
+        if (image.empty()) return false;
+
+        return enqueue(image, false, path);
+    }
+
+    /**
+     * @brief 阻塞直到队列中的图像全部写完
+     */
+    void flush() {
+        std::unique_lock<std::mutex> locker(m_mutex);
+        m_idle.wait(locker, [this]() {
+            return m_queue.empty() && m_busy == 0;
+        });
+    }
+
+    Stats stats() {
+        Stats s;
+        s.submitted = m_submitted.load(std::memory_order_relaxed);
+        s.written = m_written.load(std::memory_order_relaxed);
+        s.dropped = m_dropped.load(std::memory_order_relaxed);
+        s.failed = m_failed.load(std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            s.queue_depth = m_queue.size();
+            s.max_queue_depth = m_max_queue_depth;
+            s.queue_capacity = m_capacity;
+            s.workers = (int) m_threads.size();
+        }
+        s.encode = m_encode_time.summarize();
+        s.write = m_write_time.summarize();
+
+        return s;
+    }
+
+    static std::string format(const Stats &s) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(1);
+        ss << "export x" << s.workers << " written " << s.written << "/" << s.submitted
+           << " drop " << s.dropped << " fail " << s.failed
+           << " queue " << s.queue_depth << "/" << s.queue_capacity << " (max " << s.max_queue_depth << ")"
+           << " encode p50/p99 " << s.encode.p50_us / 1000 << "/" << s.encode.p99_us / 1000 << " ms"
+           << " write p50/p99 " << s.write.p50_us / 1000 << "/" << s.write.p99_us / 1000 << " ms";
+
+        return ss.str();
+    }
+
+private:
+    // 以下两个函数须持有 m_lifecycle_mutex
+    void startThreads(int workers, size_t queue_capacity) {
+        if (workers <= 0) workers = std::max(1, (int) std::thread::hardware_concurrency() / 2);
+
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_capacity = std::max<size_t>(queue_capacity, 1);
+            m_max_queue_depth = 0;
+        }
+        m_submitted = 0;
+        m_written = 0;
+        m_dropped = 0;
+        m_failed = 0;
+        m_encode_time.reset();
+        m_write_time.reset();
+        m_stop_flag = false;
+        for (int i = 0; i < workers; i++) {
+            m_threads.emplace_back(&ImageExporter::workLoop, this);
+        }
+        m_running = true;
+    }
+
+    void stopThreads() {
+        if (m_threads.empty()) return;
+
+        m_running = false;
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_stop_flag = true;
+        }
+        m_not_empty.notify_all();
+        m_not_full.notify_all();
+
+        for (auto &thread : m_threads) {
+            thread.join();
+        }
+        m_threads.clear();
+    }
+
+    struct Job {
+        cv::Mat image;
+        bool rgb = false;
+        std::string path;
+    };
+
+    /**
+     * @brief 确认有空位后才拷贝图像
+     *
+     * 拷贝在锁内进行，工作线程取任务时最多等待一次拷贝的时间。
+     */
+    bool enqueue(const cv::Mat &image, bool rgb, const std::string &path) {
+        if (!m_running) return false;
+
+        std::unique_lock<std::mutex> locker(m_mutex);
+
+        if (m_queue.size() >= m_capacity) {
+            switch (m_policy.spill) {
+                case SpillPolicy::DropNewest:
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                case SpillPolicy::DropOldest:
+                    m_queue.pop_front();
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                case SpillPolicy::Block:
+                    m_not_full.wait(locker, [this]() {
+                        return m_stop_flag || m_queue.size() < m_capacity;
+                    });
+                    if (m_stop_flag) return false;
+                    break;
+            }
+        }
+
+        m_queue.push_back({image.clone(), rgb, path});
+        m_max_queue_depth = std::max(m_max_queue_depth, m_queue.size());
+        m_submitted.fetch_add(1, std::memory_order_relaxed);
+
+        locker.unlock();
+        m_not_empty.notify_one();
+
+        return true;
+    }
+
+    void workLoop() {
+        while (true) {
+            Job job;
+            Policy policy;
+            {
+                std::unique_lock<std::mutex> locker(m_mutex);
+                m_not_empty.wait(locker, [this]() {
+                    return m_stop_flag || !m_queue.empty();
+                });
+                if (m_queue.empty()) break;  // 停止且已写完
+
+                job = std::move(m_queue.front());
+                m_queue.pop_front();
+                policy = m_policy;
+                m_busy++;
+            }
+            m_not_full.notify_one();
+
+            bool ok = exportImage(job, policy);
+            if (ok) {
+                m_written.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                m_failed.fetch_add(1, std::memory_order_relaxed);
+                std::cout << "Export image error: " << job.path << std::endl;
+            }
+
+            DoneCallback callback;
+            {
+                std::lock_guard<std::mutex> locker(m_mutex);
+                callback = m_done_callback;
+            }
+            if (callback) callback(job.path, ok);
+
+            {
+                std::lock_guard<std::mutex> locker(m_mutex);
+                m_busy--;
+            }
+            m_idle.notify_all();
+        }
+    }
+
+    static Format formatOf(const std::string &path, Format format) {
+        if (format != Format::Auto) return format;
+
+        std::string ext;
+        size_t dot = path.find_last_of('.');
+        if (dot != std::string::npos) ext = path.substr(dot + 1);
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) {
+            return (char) std::tolower(c);
+        });
+
+        if (ext == "tif" || ext == "tiff") return Format::Tiff;
+        if (ext == "jpg" || ext == "jpeg") return Format::Jpeg;
+        return Format::Png;
+    }
+
+    bool exportImage(const Job &job, const Policy &policy) {
+        uint64_t begin_ns = FrameMetrics::now();
+
+        cv::Mat image = job.image;
+        if (job.rgb) {
+            cv::cvtColor(job.image, image, cv::COLOR_RGB2BGR);
+        }
+
+        std::string ext;
+        std::vector<int> params;
+        switch (formatOf(job.path, policy.format)) {
+            case Format::Tiff:
+                ext = ".tiff";
+                params = {cv::IMWRITE_TIFF_COMPRESSION, policy.tiff_lzw ? 5 : 1};
+                break;
+            case Format::Jpeg:
+                ext = ".jpg";
+                params = {cv::IMWRITE_JPEG_QUALITY, policy.jpeg_quality};
+                if (image.depth() == CV_16U) image.convertTo(image, CV_8U, 1.0 / 256);  // JPEG 只支持 8 位
+                break;
+            default:
+                ext = ".png";
+                params = {cv::IMWRITE_PNG_COMPRESSION, policy.png_compression};
+                break;
+        }
+
+        std::vector<uchar> buffer;
+        try {
+            if (!cv::imencode(ext, image, buffer, params)) return false;
+        } catch (...) {
+            return false;
+        }
+
+        uint64_t encoded_ns = FrameMetrics::now();
+        m_encode_time.record(encoded_ns - begin_ns);
+
+        bool ok = writeAtomically(job.path, buffer);
+        m_write_time.record(FrameMetrics::now() - encoded_ns);
+
+        return ok;
+    }
+
+    /**
+     * @brief 写入临时文件并落盘后重命名为目标文件
+     *
+     * 临时文件名带有进程内唯一的序号，同时写入同一路径的任务互不干扰，后完成的覆盖先完成的。
+     */
+    static bool writeAtomically(const std::string &path, const std::vector<uchar> &buffer) {
+        static std::atomic<uint64_t> sequence(0);
+        std::string temp_path = path + "." + std::to_string(sequence.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+
+        FILE *file = std::fopen(temp_path.c_str(), "wb");
+        if (!file) return false;
+
+        bool ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size() && std::fflush(file) == 0;
+#ifdef _WIN32
+        ok = ok && _commit(_fileno(file)) == 0;
+#else
+        ok = ok && fsync(fileno(file)) == 0;
+#endif
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok) {
+            std::remove(temp_path.c_str());
+            return false;
+        }
+
+#ifdef _WIN32
+        // rename() 在目标已存在时失败，MoveFileEx 可直接替换
+        ok = MoveFileExA(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        ok = std::rename(temp_path.c_str(), path.c_str()) == 0;
+#endif
+        if (!ok) {
+            std::remove(temp_path.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    std::mutex m_lifecycle_mutex;       // 串行化 start() / ensureStarted() / stop()
+    std::vector<std::thread> m_threads;
+    std::atomic<bool> m_running;
+
+    std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    std::condition_variable m_idle;
+    std::deque<Job> m_queue;
+    bool m_stop_flag;
+    size_t m_capacity;
+    size_t m_max_queue_depth;
+    int m_busy;                        // 正在编码的图像数
+    Policy m_policy;
+    DoneCallback m_done_callback;
+
+    std::atomic<uint64_t> m_submitted;
+    std::atomic<uint64_t> m_written;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_failed;
+    LatencyHistogram m_encode_time;
+    LatencyHistogram m_write_time;
+};
+
+
+#endif // IMAGE_EXPORTER_HPP
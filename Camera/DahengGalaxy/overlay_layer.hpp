@@ -0,0 +1,336 @@
+#ifndef OVERLAY_LAYER_HPP
+#define OVERLAY_LAYER_HPP
+
+#include <QImage>
+#include <QPainter>
+#include <QPen>
+#include <QString>
+#include <QTransform>
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief 叠加图元，几何坐标为图像像素坐标
+ *
+ * 绘制时由 image_to_widget 把几何映射到控件坐标，线宽与字号保持控件像素大小，不随缩放变化。
+ */
+class OverlayItem {
+public:
+    explicit OverlayItem(const QPen &pen = QPen(QColor(0, 255, 0), 1))
+            : m_pen(pen) {
+        m_pen.setCosmetic(true);
+    }
+
+    virtual ~OverlayItem() {}
+
+    virtual void paint(QPainter &painter, const QTransform &image_to_widget) const = 0;
+
+protected:
+    QPen m_pen;
+};
+
+
+class OverlayLine : public OverlayItem {
+public:
+    OverlayLine(const QPointF &p1, const QPointF &p2, const QPen &pen = QPen(QColor(0, 255, 0), 1))
+            : OverlayItem(pen), m_p1(p1), m_p2(p2) {}
+
+    void paint(QPainter &painter, const QTransform &image_to_widget) const override {
+        painter.setPen(m_pen);
+        painter.drawLine(image_to_widget.map(m_p1), image_to_widget.map(m_p2));
+    }
+
+private:
+    QPointF m_p1;
+    QPointF m_p2;
+};
+
+
+class OverlayRect : public OverlayItem {
+public:
+    explicit OverlayRect(const QRectF &rect, const QPen &pen = QPen(QColor(0, 255, 0), 1))
+            : OverlayItem(pen), m_rect(rect) {}
+
+    void paint(QPainter &painter, const QTransform &image_to_widget) const override {
+        painter.setPen(m_pen);
+        painter.setBrush(Qt::NoBrush);
+        painter.drawRect(image_to_widget.mapRect(m_rect));
+    }
+
+private:
+    QRectF m_rect;
+};
+
+
+class OverlayEllipse : public OverlayItem {
+public:
+    OverlayEllipse(const QPointF &center, double radius_x, double radius_y,
+                   const QPen &pen = QPen(QColor(0, 255, 0), 1))
+            : OverlayItem(pen), m_center(center), m_radius_x(radius_x), m_radius_y(radius_y) {}
+
+    void paint(QPainter &painter, const QTransform &image_to_widget) const override {
+        QRectF rect = image_to_widget.mapRect(QRectF(m_center.x() - m_radius_x, m_center.y() - m_radius_y,
+                                                     m_radius_x * 2, m_radius_y * 2));
+        painter.setPen(m_pen);
+        painter.setBrush(Qt::NoBrush);
+        painter.drawEllipse(rect.center(), rect.width() / 2, rect.height() / 2);
+    }
+
+private:
+    QPointF m_center;
+    double m_radius_x;
+    double m_radius_y;
+};
+
+
+/**
+ * @brief 折线或多边形（如匹配框、轮廓）
+ */
+class OverlayPolyline : public OverlayItem {
+public:
+    OverlayPolyline(std::vector<QPointF> points, bool closed, const QPen &pen = QPen(QColor(0, 255, 0), 1))
+            : OverlayItem(pen), m_points(std::move(points)), m_closed(closed) {}
+
+    void paint(QPainter &painter, const QTransform &image_to_widget) const override {
+        if (m_points.empty()) return;
+
+        std::vector<QPointF> mapped;
+        mapped.reserve(m_points.size() + 1);
+        for (const QPointF &point : m_points) {
+            mapped.push_back(image_to_widget.map(point));
+        }
+        if (m_closed) mapped.push_back(mapped.front());
+
+        painter.setPen(m_pen);
+        painter.drawPolyline(mapped.data(), (int) mapped.size());
+    }
+
+private:
+    std::vector<QPointF> m_points;
+    bool m_closed;
+};
+
+
+class OverlayText : public OverlayItem {
+public:
+    OverlayText(const QPointF &position, const QString &text, const QPen &pen = QPen(QColor(0, 255, 0), 1))
+            : OverlayItem(pen), m_position(position), m_text(text) {}
+
+    void paint(QPainter &painter, const QTransform &image_to_widget) const override {
+        painter.setPen(m_pen);
+        painter.drawText(image_to_widget.map(m_position), m_text);
+    }
+
+private:
+    QPointF m_position;
+    QString m_text;
+};
+
+
+/**
+ * @brief 十字线，half_length 为图像像素
+ */
+class OverlayCrosshair : public OverlayItem {
+public:
+    OverlayCrosshair(const QPointF &center, double half_length, const QPen &pen = QPen(QColor(255, 0, 0), 1))
+            : OverlayItem(pen), m_center(center), m_half_length(half_length) {}
+
+    void paint(QPainter &painter, const QTransform &image_to_widget) const override {
+        double x = m_center.x(), y = m_center.y();
+
+        painter.setPen(m_pen);
+        painter.drawLine(image_to_widget.map(QPointF(x - m_half_length, y)),
+                         image_to_widget.map(QPointF(x + m_half_length, y)));
+        painter.drawLine(image_to_widget.map(QPointF(x, y - m_half_length)),
+                         image_to_widget.map(QPointF(x, y + m_half_length)));
+    }
+
+private:
+    QPointF m_center;
+    double m_half_length;
+};
+
+
+/**
+ * @brief 比例尺：从 origin 向右 length 个图像像素，末端带刻度与标注（如 "1 mm"）
+ */
+class OverlayScaleBar : public OverlayItem {
+public:
+    OverlayScaleBar(const QPointF &origin, double length, const QString &label,
+                    const QPen &pen = QPen(QColor(255, 255, 0), 2))
+            : OverlayItem(pen), m_origin(origin), m_length(length), m_label(label) {}
+
+    void paint(QPainter &painter, const QTransform &image_to_widget) const override {
+        QPointF left = image_to_widget.map(m_origin);
+        QPointF right = image_to_widget.map(QPointF(m_origin.x() + m_length, m_origin.y()));
+        const double tick = 4;  // 控件像素
+
+        painter.setPen(m_pen);
+        painter.drawLine(left, right);
+        painter.drawLine(QPointF(left.x(), left.y() - tick), QPointF(left.x(), left.y() + tick));
+        painter.drawLine(QPointF(right.x(), right.y() - tick), QPointF(right.x(), right.y() + tick));
+        painter.drawText(QPointF(left.x(), left.y() - tick - 2), m_label);
+    }
+
+private:
+    QPointF m_origin;
+    double m_length;
+    QString m_label;
+};
+
+
+/**
+ * @brief 保留模式的叠加层
+ *
+ * 图元注册后一直保留，直到被移除；所有图元绘制到一张缓存图像中，只有图元增删、分组显隐、
+ * 控件尺寸或图像到控件的映射改变时才重新绘制，每帧只需合成这一张图像，
+ * 绘制开销不随图元数量增加。只能在界面线程中使用。
+ */
+class OverlayLayer {
+public:
+    using ChangedCallback = std::function<void()>;
+
+    OverlayLayer()
+            : m_next_id(1),
+              m_revision(1),
+              m_cache_revision(0),
+              m_cache_dpr(0) {}
+
+    /**
+     * @brief 图元改变时调用（如触发控件重绘）
+     */
+    void setChangedCallback(ChangedCallback callback) {
+        m_changed_callback = std::move(callback);
+    }
+
+    /**
+     * @param group - 分组名，可按组整体清除或隐藏（如 "roi"、"match"）
+     * @return 图元编号，用于移除
+     */
+    int add(std::shared_ptr<const OverlayItem> item, const std::string &group = std::string()) {
+        if (!item) return 0;
+
+        int id = m_next_id++;
+        m_items.emplace(id, Entry{std::move(item), group});
+        changed();
+
+        return id;
+    }
+
+    void remove(int id) {
+        if (m_items.erase(id) > 0) changed();
+    }
+
+    void clearGroup(const std::string &group) {
+        bool removed = false;
+        for (auto it = m_items.begin(); it != m_items.end();) {
+            if (it->second.group == group) {
+                it = m_items.erase(it);
+                removed = true;
+            } else {
+                ++it;
+            }
+        }
+
+        if (removed) changed();
+    }
+
+    void clear() {
+        if (m_items.empty()) return;
+
+        m_items.clear();
+        changed();
+    }
+
+    void setGroupVisible(const std::string &group, bool visible) {
+        bool hidden = m_hidden_groups.count(group) > 0;
+        if (hidden == !visible) return;
+
+        if (visible) {
+            m_hidden_groups.erase(group);
+        } else {
+            m_hidden_groups.insert(group);
+        }
+        changed();
+    }
+
+    bool isEmpty() const {
+        return m_items.empty();
+    }
+
+    size_t size() const {
+        return m_items.size();
+    }
+
+    /**
+     * @brief 返回缓存的叠加图像（控件尺寸、透明背景），必要时重新绘制
+     * @param widget_size - 控件逻辑尺寸
+     * @param image_to_widget - 图像像素坐标到控件逻辑坐标的映射
+     * @param device_pixel_ratio - 缓存图像按设备像素分配，高分屏下不模糊
+     */
+    const QImage &render(const QSize &widget_size, const QTransform &image_to_widget, qreal device_pixel_ratio) {
+        if (m_cache_revision == m_revision && m_cache_size == widget_size &&
+            m_cache_transform == image_to_widget && m_cache_dpr == device_pixel_ratio) {
+            return m_cache;
+        }
+
+        QSize pixel_size((int) std::lround(widget_size.width() * device_pixel_ratio),
+                         (int) std::lround(widget_size.height() * device_pixel_ratio));
+        if (m_cache.size() != pixel_size) {
+            m_cache = QImage(pixel_size, QImage::Format_ARGB32_Premultiplied);
+        }
+        m_cache.setDevicePixelRatio(device_pixel_ratio);
+        m_cache.fill(Qt::transparent);
+
+        QPainter painter(&m_cache);
+        painter.setRenderHint(QPainter::Antialiasing);
+        for (const auto &item : m_items) {
+            if (m_hidden_groups.count(item.second.group) > 0) continue;
+            item.second.item->paint(painter, image_to_widget);
+        }
+        painter.end();
+
+        m_cache_revision = m_revision;
+        m_cache_size = widget_size;
+        m_cache_transform = image_to_widget;
+        m_cache_dpr = device_pixel_ratio;
+
+        return m_cache;
+    }
+
+private:
+    struct Entry {
+        std::shared_ptr<const OverlayItem> item;
+        std::string group;
+    };
+
+    void changed() {
+        m_revision++;
+        if (m_changed_callback) m_changed_callback();
+    }
+
+private:
+    std::map<int, Entry> m_items;               // 按编号（即注册顺序）绘制
+    std::set<std::string> m_hidden_groups;
+    int m_next_id;
+    uint64_t m_revision;                        // 图元每次改变时递增
+    ChangedCallback m_changed_callback;
+
+    QImage m_cache;
+    uint64_t m_cache_revision;
+    QSize m_cache_size;
+    QTransform m_cache_transform;
+    qreal m_cache_dpr;
+};
+
+
+#endif // OVERLAY_LAYER_HPP
@@ -0,0 +1,257 @@
+#ifndef PIXEL_FORMAT_HPP
+#define PIXEL_FORMAT_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include "opencv2/opencv.hpp"
+
+
+/**
+ * @brief 相机输出的像素格式（GenICam PixelFormat 名称）
+ *
+ * 控制器把每帧转换为显示与算法可直接使用的格式，且每帧只转换一次：
+ *   Mono8                         -> CV_8UC1
+ *   Mono10/12(Packed)、Mono16     -> CV_16UC1，数值左移到高位对齐 16 位
+ *   Bayer**8、RGB8                -> CV_8UC3，RGB 通道顺序
+ */
+enum class PixelFormat {
+    Unknown,
+    Mono8,
+    Mono10,          // 每像素 2 字节，低 10 位有效
+    Mono12,          // 每像素 2 字节，低 12 位有效
+    Mono16,
+    Mono10Packed,    // 每 2 像素 3 字节（GigE Vision 排布）
+    Mono12Packed,    // 每 2 像素 3 字节（GigE Vision 排布）
+    BayerRG8,
+    BayerGB8,
+    BayerGR8,
+    BayerBG8,
+    RGB8,
+};
+
+inline PixelFormat pixelFormatFromName(const std::string &name) {
+    if (name == "Mono8") return PixelFormat::Mono8;
+    if (name == "Mono10") return PixelFormat::Mono10;
+    if (name == "Mono12") return PixelFormat::Mono12;
+    if (name == "Mono16") return PixelFormat::Mono16;
+    if (name == "Mono10Packed") return PixelFormat::Mono10Packed;
+    if (name == "Mono12Packed") return PixelFormat::Mono12Packed;
+    if (name == "BayerRG8") return PixelFormat::BayerRG8;
+    if (name == "BayerGB8") return PixelFormat::BayerGB8;
+    if (name == "BayerGR8") return PixelFormat::BayerGR8;
+    if (name == "BayerBG8") return PixelFormat::BayerBG8;
+    if (name == "RGB8" || name == "RGB8Packed") return PixelFormat::RGB8;
+
+    return PixelFormat::Unknown;
+}
+
+inline const char *pixelFormatName(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::Mono8: return "Mono8";
+        case PixelFormat::Mono10: return "Mono10";
+        case PixelFormat::Mono12: return "Mono12";
+        case PixelFormat::Mono16: return "Mono16";
+        case PixelFormat::Mono10Packed: return "Mono10Packed";
+        case PixelFormat::Mono12Packed: return "Mono12Packed";
+        case PixelFormat::BayerRG8: return "BayerRG8";
+        case PixelFormat::BayerGB8: return "BayerGB8";
+        case PixelFormat::BayerGR8: return "BayerGR8";
+        case PixelFormat::BayerBG8: return "BayerBG8";
+        case PixelFormat::RGB8: return "RGB8";
+        default: return "Unknown";
+    }
+}
+
+/**
+ * @brief 相机交付的一帧原始数据的字节数
+ */
+inline size_t pixelFormatRawSize(PixelFormat format, int width, int height) {
+    size_t pixels = (size_t) width * height;
+
+    switch (format) {
+        case PixelFormat::Mono10:
+        case PixelFormat::Mono12:
+        case PixelFormat::Mono16:
+            return pixels * 2;
+        case PixelFormat::Mono10Packed:
+        case PixelFormat::Mono12Packed:
+            return (pixels * 3 + 1) / 2;
+        case PixelFormat::RGB8:
+            return pixels * 3;
+        default:
+            return pixels;
+    }
+}
+
+/**
+ * @brief 转换后的 OpenCV 类型
+ */
+inline int pixelFormatOutputType(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::Mono10:
+        case PixelFormat::Mono12:
+        case PixelFormat::Mono16:
+        case PixelFormat::Mono10Packed:
+        case PixelFormat::Mono12Packed:
+            return CV_16UC1;
+        case PixelFormat::BayerRG8:
+        case PixelFormat::BayerGB8:
+        case PixelFormat::BayerGR8:
+        case PixelFormat::BayerBG8:
+        case PixelFormat::RGB8:
+            return CV_8UC3;
+        default:
+            return CV_8UC1;
+    }
+}
+
+inline int pixelFormatOutputBytesPerPixel(PixelFormat format) {
+    switch (pixelFormatOutputType(format)) {
+        case CV_16UC1: return 2;
+        case CV_8UC3: return 3;
+        default: return 1;
+    }
+}
+
+/**
+ * @brief 输出帧中的饱和值：16 位输出高位对齐，如 Mono12 为 0xFFF0
+ */
+inline int pixelFormatOutputMaxValue(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::Mono10:
+        case PixelFormat::Mono10Packed:
+            return 0x3FF << 6;
+        case PixelFormat::Mono12:
+        case PixelFormat::Mono12Packed:
+            return 0xFFF << 4;
+        case PixelFormat::Mono16:
+            return 0xFFFF;
+        default:
+            return 0xFF;
+    }
+}
+
+/**
+ * @brief 原始数据与输出排布相同，采集回调中直接拷贝即可，无需转换线程
+ */
+inline bool pixelFormatIsPassThrough(PixelFormat format) {
+    return format == PixelFormat::Mono8 || format == PixelFormat::Mono16 || format == PixelFormat::RGB8;
+}
+
+
+namespace pixel_format_detail {
+
+// GigE Vision Mono12Packed：b0 = p0[11:4]，b1 = p0[3:0] | p1[3:0] << 4，b2 = p1[11:4]
+inline void unpackMono12Packed(const uint8_t *src, uint16_t *dst, size_t pixels) {
+    size_t pairs = pixels / 2;
+    for (size_t i = 0; i < pairs; i++) {
+        const uint8_t *s = src + i * 3;
+        dst[i * 2] = (uint16_t) ((s[0] << 8) | ((s[1] & 0x0F) << 4));
+        dst[i * 2 + 1] = (uint16_t) ((s[2] << 8) | (s[1] & 0xF0));
+    }
+    if (pixels & 1) {
+        const uint8_t *s = src + pairs * 3;
+        dst[pixels - 1] = (uint16_t) ((s[0] << 8) | ((s[1] & 0x0F) << 4));
+    }
+}
+
+// GigE Vision Mono10Packed：b0 = p0[9:2]，b1 = p0[1:0] | p1[1:0] << 4，b2 = p1[9:2]
+inline void unpackMono10Packed(const uint8_t *src, uint16_t *dst, size_t pixels) {
+    size_t pairs = pixels / 2;
+    for (size_t i = 0; i < pairs; i++) {
+        const uint8_t *s = src + i * 3;
+        dst[i * 2] = (uint16_t) ((s[0] << 8) | ((s[1] & 0x03) << 6));
+        dst[i * 2 + 1] = (uint16_t) ((s[2] << 8) | ((s[1] & 0x30) << 2));
+    }
+    if (pixels & 1) {
+        const uint8_t *s = src + pairs * 3;
+        dst[pixels - 1] = (uint16_t) ((s[0] << 8) | ((s[1] & 0x03) << 6));
+    }
+}
+
+}  // namespace pixel_format_detail
+
+
+/**
+ * @brief 把一帧原始数据转换为 pixelFormatOutputType() 描述的格式
+ *
+ * Bayer 插值与位深扩展交给 OpenCV（内部已向量化）；打包格式逐对像素解包，循环无分支便于编译器向量化。
+ *
+ * @param dst_step - 输出每行字节数
+ * @return 格式不支持时返回 false
+ */
+inline bool convertPixelFormat(PixelFormat format, const void *src, int width, int height,
+                               void *dst, size_t dst_step) {
+    const uint8_t *src_bytes = static_cast<const uint8_t *>(src);
+    uint8_t *src_data = const_cast<uint8_t *>(src_bytes);
+    cv::Mat output(height, width, pixelFormatOutputType(format), dst, dst_step);
+
+    // 注意：OpenCV 的 Bayer 命名以第二行第二、三个像素为准，与 GenICam 命名相差一行一列
+    switch (format) {
+        case PixelFormat::Mono8:
+            cv::Mat(height, width, CV_8UC1, src_data).copyTo(output);
+            return true;
+        case PixelFormat::Mono16:
+            cv::Mat(height, width, CV_16UC1, src_data).copyTo(output);
+            return true;
+        case PixelFormat::RGB8:
+            cv::Mat(height, width, CV_8UC3, src_data).copyTo(output);
+            return true;
+        case PixelFormat::Mono10:
+            cv::Mat(height, width, CV_16UC1, src_data).convertTo(output, CV_16U, 64);
+            return true;
+        case PixelFormat::Mono12:
+            cv::Mat(height, width, CV_16UC1, src_data).convertTo(output, CV_16U, 16);
+            return true;
+        case PixelFormat::BayerRG8:
+            cv::cvtColor(cv::Mat(height, width, CV_8UC1, src_data), output, cv::COLOR_BayerBG2RGB);
+            return true;
+        case PixelFormat::BayerGB8:
+            cv::cvtColor(cv::Mat(height, width, CV_8UC1, src_data), output, cv::COLOR_BayerGR2RGB);
+            return true;
+        case PixelFormat::BayerGR8:
+            cv::cvtColor(cv::Mat(height, width, CV_8UC1, src_data), output, cv::COLOR_BayerGB2RGB);
+            return true;
+        case PixelFormat::BayerBG8:
+            cv::cvtColor(cv::Mat(height, width, CV_8UC1, src_data), output, cv::COLOR_BayerRG2RGB);
+            return true;
+        default:
+            break;
+    }
+
+    // 打包格式：输入按整帧连续存放，输出逐行解包
+    if (format != PixelFormat::Mono10Packed && format != PixelFormat::Mono12Packed) return false;
+
+    if (dst_step == (size_t) width * 2 && (width % 2) == 0) {
+        if (format == PixelFormat::Mono12Packed) {
+            pixel_format_detail::unpackMono12Packed(src_bytes, static_cast<uint16_t *>(dst), (size_t) width * height);
+        } else {
+            pixel_format_detail::unpackMono10Packed(src_bytes, static_cast<uint16_t *>(dst), (size_t) width * height);
+        }
+        return true;
+    }
+
+    // 奇数宽度时像素对跨行，逐像素解包
+    uint8_t *dst_bytes = static_cast<uint8_t *>(dst);
+    for (int y = 0; y < height; y++) {
+        uint16_t *row = reinterpret_cast<uint16_t *>(dst_bytes + y * dst_step);
+        for (int x = 0; x < width; x++) {
+            size_t n = (size_t) y * width + x;
+            const uint8_t *s = src_bytes + n / 2 * 3;
+            if (format == PixelFormat::Mono12Packed) {
+                row[x] = (n & 1) ? (uint16_t) ((s[2] << 8) | (s[1] & 0xF0))
+                                 : (uint16_t) ((s[0] << 8) | ((s[1] & 0x0F) << 4));
+            } else {
+                row[x] = (n & 1) ? (uint16_t) ((s[2] << 8) | ((s[1] & 0x30) << 2))
+                                 : (uint16_t) ((s[0] << 8) | ((s[1] & 0x03) << 6));
+            }
+        }
+    }
+
+    return true;
+}
+
+
+#endif // PIXEL_FORMAT_HPP
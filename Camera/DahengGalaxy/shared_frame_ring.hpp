@@ -0,0 +1,707 @@
+#ifndef SHARED_FRAME_RING_HPP
+#define SHARED_FRAME_RING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "opencv2/opencv.hpp"
+
+
+/**
+ * 共享内存帧环形缓冲区布局（POSIX 共享内存对象，如 /dev/shm/camera_<序列号>）
+ *
+ *   [0, data_offset)                  SharedFrameRingHeader，按 4096 对齐
+ *   [data_offset, ...)                第 i 个槽位于 data_offset + i * slot_stride，槽头之后为图像数据
+ *
+ * 发布序号从 1 开始，第 n 帧写入槽位 (n - 1) % slot_count。每个槽位以 lock 作顺序锁：写入期间为奇数 2n - 1，
+ * 写完为偶数 2n。读端在使用数据前后各检查一次 lock，不相等即说明数据已被覆盖。
+ * 读端只读映射帧数据；等待通知时另以读写方式映射头部，修改其中的 waiters 与互斥锁，因此读端需要对
+ * 共享内存对象有读写权限（见 SharedFrameRingPublisher::create() 的 mode）。读端数量不限，读端崩溃不影响发布端。
+ */
+
+static constexpr char kSharedFrameRingMagic[8] = {'F', 'R', 'M', 'R', 'I', 'N', 'G', '1'};
+static constexpr uint32_t kSharedFrameRingVersion = 2;
+static constexpr uint64_t kSharedFrameRingAlignment = 4096;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory atomics must be lock free");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared memory atomics must be lock free");
+
+struct SharedFrameRingHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t slot_count;
+    uint64_t slot_stride;                    // 相邻槽位的偏移间隔
+    uint64_t slot_capacity;                  // 每个槽位可容纳的图像数据字节数
+    uint64_t data_offset;
+    uint64_t total_size;
+    int64_t owner_pid;                       // 发布端进程号，用于判断同名对象是否为崩溃遗留
+
+    std::atomic<uint64_t> write_sequence;    // 最近写完的发布序号，0 表示尚无帧
+    std::atomic<uint32_t> closed;            // 发布端已停止
+    std::atomic<uint32_t> waiters;           // 正在等待通知的读端数，为 0 时发布端不发通知
+
+#ifndef _WIN32
+    pthread_mutex_t mutex;                   // 进程间共享、robust，只用于等待通知
+    pthread_cond_t cond;
+#endif
+};
+
+struct SharedFrameSlotHeader {
+    std::atomic<uint64_t> lock;
+    uint64_t sequence;                       // 发布序号
+    uint64_t frame_id;                       // SDK 帧号
+    uint64_t timestamp;                      // SDK 时间戳
+    uint64_t size;                           // 图像数据字节数
+    int32_t width;
+    int32_t height;
+    int32_t step;
+    int32_t cv_type;
+    uint8_t reserved[72];
+};
+
+static_assert(sizeof(SharedFrameSlotHeader) == 128, "unexpected SharedFrameSlotHeader layout");
+
+static constexpr uint64_t kSharedFrameSlotHeaderSize = sizeof(SharedFrameSlotHeader);  // 图像数据按 64 字节对齐
+
+inline uint64_t sharedFrameRingAlignUp(uint64_t value, uint64_t alignment = kSharedFrameRingAlignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+
+enum class SharedFrameStatus {
+    Ok,
+    Timeout,        // 超时没有新帧
+    Overwritten,    // 请求的帧已被新帧覆盖
+    Closed,         // 发布端已停止
+    Error,          // 未打开，或无法以读写方式映射头部而不能等待通知
+};
+
+
+/**
+ * @brief 共享内存帧环形缓冲区的公共部分：映射与进程间通知
+ */
+class SharedFrameRing {
+public:
+    SharedFrameRing()
+            : m_data(nullptr),
+              m_size(0),
+              m_fd(-1) {}
+
+    ~SharedFrameRing() {
+        unmapWritableHeader();
+        unmap();
+    }
+
+    SharedFrameRing(const SharedFrameRing &) = delete;
+    SharedFrameRing &operator=(const SharedFrameRing &) = delete;
+
+    bool isOpen() const {
+        return m_data != nullptr;
+    }
+
+    const std::string &name() const {
+        return m_name;
+    }
+
+    uint32_t slotCount() const {
+        return m_data ? header()->slot_count : 0;
+    }
+
+    uint64_t slotCapacity() const {
+        return m_data ? header()->slot_capacity : 0;
+    }
+
+    /**
+     * @brief 最近写完的发布序号
+     */
+    uint64_t latestSequence() const {
+        return m_data ? header()->write_sequence.load(std::memory_order_acquire) : 0;
+    }
+
+protected:
+    SharedFrameRingHeader *header() const {
+        return reinterpret_cast<SharedFrameRingHeader *>(m_data);
+    }
+
+    SharedFrameSlotHeader *slot(uint64_t sequence) const {
+        SharedFrameRingHeader *h = header();
+        uint64_t index = (sequence - 1) % h->slot_count;
+        return reinterpret_cast<SharedFrameSlotHeader *>(m_data + h->data_offset + index * h->slot_stride);
+    }
+
+    uint8_t *slotData(SharedFrameSlotHeader *slot_header) const {
+        return reinterpret_cast<uint8_t *>(slot_header) + kSharedFrameSlotHeaderSize;
+    }
+
+    /**
+     * @param mode - 创建时的访问权限，不受 umask 影响
+     */
+    bool map(const std::string &name, bool create, size_t size, unsigned int mode = 0) {
+        unmap();
+        m_name = name;
+
+#ifdef _WIN32
+        (void) create;
+        (void) size;
+        (void) mode;
+        std::cout << "Shared frame ring is only supported on POSIX systems" << std::endl;
+        return false;
+#else
+        if (create) {
+            m_fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, (mode_t) mode);
+            if (m_fd < 0 && errno == EEXIST) {
+                // 只清除已停止或发布进程已退出的遗留对象，不破坏其它发布端正在使用的同名缓冲区
+                if (!isStale(name)) {
+                    std::cout << "Shared frame ring already in use: " << name << std::endl;
+                    return false;
+                }
+                shm_unlink(name.c_str());
+                m_fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, (mode_t) mode);
+            }
+            if (m_fd < 0) return false;
+            if (fchmod(m_fd, (mode_t) mode) != 0 || ftruncate(m_fd, (off_t) size) != 0) {
+                shm_unlink(name.c_str());
+                return false;
+            }
+        } else {
+            m_fd = shm_open(name.c_str(), O_RDONLY, 0);
+            if (m_fd < 0) return false;
+
+            struct stat st;
+            if (fstat(m_fd, &st) != 0 || (size_t) st.st_size < sizeof(SharedFrameRingHeader)) return false;
+            size = (size_t) st.st_size;
+        }
+
+        void *data = mmap(nullptr, size, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, m_fd, 0);
+        if (data == MAP_FAILED) {
+            if (create) shm_unlink(name.c_str());
+            return false;
+        }
+
+        m_data = static_cast<uint8_t *>(data);
+        m_size = size;
+
+        return true;
+#endif
+    }
+
+    void unmap() {
+#ifndef _WIN32
+        if (m_data) munmap(m_data, m_size);
+        if (m_fd >= 0) ::close(m_fd);
+#endif
+        m_data = nullptr;
+        m_size = 0;
+        m_fd = -1;
+    }
+
+#ifndef _WIN32
+    /**
+     * @brief 同名对象是否可以删除：不是本格式（如创建到一半时崩溃）、已停止，或发布进程已不存在
+     *
+     * 无法读取或为其它版本时按仍在使用处理，由调用方报错。
+     */
+    static bool isStale(const std::string &name) {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        if ((size_t) st.st_size < sizeof(SharedFrameRingHeader)) {
+            ::close(fd);
+            return true;
+        }
+
+        void *data = mmap(nullptr, sizeof(SharedFrameRingHeader), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) return false;
+
+        const SharedFrameRingHeader *h = static_cast<const SharedFrameRingHeader *>(data);
+        bool stale;
+        if (std::memcmp(h->magic, kSharedFrameRingMagic, sizeof(h->magic)) != 0) {
+            stale = true;
+        } else if (h->version != kSharedFrameRingVersion) {
+            stale = false;
+        } else {
+            stale = h->closed.load(std::memory_order_acquire) != 0 ||
+                    (kill((pid_t) h->owner_pid, 0) != 0 && errno == ESRCH);
+        }
+        munmap(data, sizeof(SharedFrameRingHeader));
+
+        return stale;
+    }
+
+    // 持有锁的读端崩溃后恢复锁的一致性
+    static void lockRobust(pthread_mutex_t *mutex) {
+        if (pthread_mutex_lock(mutex) == EOWNERDEAD) pthread_mutex_consistent(mutex);
+    }
+#endif
+
+    /**
+     * @brief 唤醒所有等待中的读端；没有读端等待时只有一次原子读
+     */
+    void notifyReaders() {
+#ifndef _WIN32
+        SharedFrameRingHeader *h = header();
+        if (h->waiters.load(std::memory_order_seq_cst) == 0) return;
+
+        lockRobust(&h->mutex);
+        pthread_cond_broadcast(&h->cond);
+        pthread_mutex_unlock(&h->mutex);
+#endif
+    }
+
+    /**
+     * @brief 阻塞直到发布序号大于 after_sequence 或发布端停止
+     * @return 超时返回 Timeout；无法映射可写头部（如没有写权限）时返回 Error，重试也不会成功
+     */
+    SharedFrameStatus waitSequence(uint64_t after_sequence, int timeout_ms) {
+#ifdef _WIN32
+        (void) after_sequence;
+        (void) timeout_ms;
+        return SharedFrameStatus::Error;
+#else
+        SharedFrameRingHeader *h = header();
+
+        auto ready = [h, after_sequence]() {
+            return h->write_sequence.load(std::memory_order_seq_cst) > after_sequence ||
+                   h->closed.load(std::memory_order_acquire) != 0;
+        };
+        if (ready()) return SharedFrameStatus::Ok;
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long) (timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        // 读端的主映射是只读的，等待时另外以读写方式映射头部
+        SharedFrameRingHeader *shared = writableHeader();
+        if (!shared) return SharedFrameStatus::Error;
+
+        lockRobust(&shared->mutex);
+        shared->waiters.fetch_add(1, std::memory_order_seq_cst);
+
+        bool ok = true;
+        while (!ready()) {
+            int rc = pthread_cond_timedwait(&shared->cond, &shared->mutex, &deadline);
+            if (rc == EOWNERDEAD) {
+                pthread_mutex_consistent(&shared->mutex);
+            } else if (rc == ETIMEDOUT) {
+                ok = ready();
+                break;
+            }
+        }
+
+        shared->waiters.fetch_sub(1, std::memory_order_seq_cst);
+        pthread_mutex_unlock(&shared->mutex);
+
+        return ok ? SharedFrameStatus::Ok : SharedFrameStatus::Timeout;
+#endif
+    }
+
+private:
+#ifndef _WIN32
+    SharedFrameRingHeader *writableHeader() {
+        if (m_writable_header) return m_writable_header;
+
+        int fd = shm_open(m_name.c_str(), O_RDWR, 0);
+        if (fd < 0) return nullptr;
+
+        size_t size = (size_t) header()->data_offset;
+        void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) return nullptr;
+
+        m_writable_header = static_cast<SharedFrameRingHeader *>(data);
+        m_writable_size = size;
+
+        return m_writable_header;
+    }
+
+protected:
+    void unmapWritableHeader() {
+        if (m_writable_header) munmap(m_writable_header, m_writable_size);
+        m_writable_header = nullptr;
+        m_writable_size = 0;
+    }
+
+private:
+    SharedFrameRingHeader *m_writable_header = nullptr;
+    size_t m_writable_size = 0;
+#else
+protected:
+    void unmapWritableHeader() {}
+#endif
+
+protected:
+    std::string m_name;
+    uint8_t *m_data;
+    size_t m_size;
+    int m_fd;
+};
+
+
+/**
+ * @brief 发布端：创建共享内存对象，把帧拷贝进环形缓冲区并通知读端
+ *
+ * 只能有一个发布线程。写入不等待读端，读端跟不上时旧帧被覆盖，由读端按序号检测。
+ */
+class SharedFrameRingPublisher : public SharedFrameRing {
+public:
+    ~SharedFrameRingPublisher() {
+        close();
+    }
+
+    /**
+     * @param name - 共享内存对象名，以 '/' 开头，如 "/camera_SN001"；同名对象仍被其它发布端使用时失败
+     * @param slot_count - 槽位数，决定读端允许的最大滞后帧数
+     * @param slot_capacity - 每帧图像数据的最大字节数
+     * @param mode - 共享内存对象的访问权限，默认只允许本用户；其它用户的读端需要读写权限，如 0660 并加入同组
+     */
+    bool create(const std::string &name, uint32_t slot_count, uint64_t slot_capacity, unsigned int mode = 0600) {
+        close();
+
+        if (slot_count == 0 || slot_capacity == 0) return false;
+
+        uint64_t data_offset = sharedFrameRingAlignUp(sizeof(SharedFrameRingHeader));
+        uint64_t slot_stride = sharedFrameRingAlignUp(kSharedFrameSlotHeaderSize + slot_capacity);
+        uint64_t total_size = data_offset + slot_count * slot_stride;
+
+        if (!map(name, true, (size_t) total_size, mode)) {
+            std::cout << "Shared frame ring create error: " << name << std::endl;
+            unmap();
+            return false;
+        }
+
+        // 新建对象的内容为 0：所有槽位 lock 为 0，表示从未写入
+        SharedFrameRingHeader *h = header();
+        std::memcpy(h->magic, kSharedFrameRingMagic, sizeof(h->magic));
+        h->version = kSharedFrameRingVersion;
+        h->slot_count = slot_count;
+        h->slot_stride = slot_stride;
+        h->slot_capacity = slot_capacity;
+        h->data_offset = data_offset;
+        h->total_size = total_size;
+#ifdef _WIN32
+        h->owner_pid = 0;
+#else
+        h->owner_pid = (int64_t) getpid();
+#endif
+        h->write_sequence.store(0, std::memory_order_relaxed);
+        h->closed.store(0, std::memory_order_relaxed);
+        h->waiters.store(0, std::memory_order_relaxed);
+
+#ifndef _WIN32
+        pthread_mutexattr_t mutex_attr;
+        pthread_mutexattr_init(&mutex_attr);
+        pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&mutex_attr, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&h->mutex, &mutex_attr);
+        pthread_mutexattr_destroy(&mutex_attr);
+
+        pthread_condattr_t cond_attr;
+        pthread_condattr_init(&cond_attr);
+        pthread_condattr_setpshared(&cond_attr, PTHREAD_PROCESS_SHARED);
+        pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&h->cond, &cond_attr);
+        pthread_condattr_destroy(&cond_attr);
+#endif
+
+        m_sequence = 0;
+
+        return true;
+    }
+
+    /**
+     * @brief 通知读端发布端已停止，并删除共享内存对象名；已映射的读端仍可读取剩余的帧
+     */
+    void close() {
+        if (!isOpen()) return;
+
+        header()->closed.store(1, std::memory_order_seq_cst);
+        notifyReaders();
+
+#ifndef _WIN32
+        shm_unlink(m_name.c_str());
+#endif
+        unmap();
+    }
+
+    /**
+     * @brief 写入一帧
+     * @return 未打开或图像大于槽位容量时返回 false
+     */
+    bool publish(const cv::Mat &image, uint64_t frame_id, uint64_t timestamp) {
+        if (!isOpen() || image.empty()) return false;
+
+        uint64_t row_size = (uint64_t) image.cols * image.elemSize();
+        uint64_t size = row_size * (uint64_t) image.rows;
+        if (size > header()->slot_capacity) return false;
+
+        uint64_t sequence = m_sequence + 1;
+        SharedFrameSlotHeader *s = slot(sequence);
+
+        s->lock.store(2 * sequence - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        s->sequence = sequence;
+        s->frame_id = frame_id;
+        s->timestamp = timestamp;
+        s->size = size;
+        s->width = image.cols;
+        s->height = image.rows;
+        s->step = (int32_t) row_size;
+        s->cv_type = image.type();
+
+        uint8_t *dst = slotData(s);
+        if (image.isContinuous()) {
+            std::memcpy(dst, image.data, (size_t) size);
+        } else {
+            for (int y = 0; y < image.rows; y++) {
+                std::memcpy(dst + y * row_size, image.ptr(y), (size_t) row_size);
+            }
+        }
+
+        s->lock.store(2 * sequence, std::memory_order_release);
+        header()->write_sequence.store(sequence, std::memory_order_seq_cst);
+        m_sequence = sequence;
+
+        notifyReaders();
+
+        return true;
+    }
+
+    uint64_t publishedCount() const {
+        return m_sequence;
+    }
+
+private:
+    uint64_t m_sequence = 0;                 // 仅发布线程访问
+};
+
+
+/**
+ * @brief 读端（客户端库）：只读映射帧数据，零拷贝读取帧
+ *
+ * next() 等待新帧时会另以读写方式映射头部；没有写权限时 next() 返回 Error，只能用 readLatest() 轮询。
+ *
+ * 典型用法：
+ *
+ *   SharedFrameRingReader reader;
+ *   reader.open("/camera_SN001");
+ *   SharedFrameRingReader::View view;
+ *   while (reader.next(view, 1000) != SharedFrameStatus::Closed) {
+ *       ...处理 view.mat()...
+ *       if (!reader.isValid(view)) { 处理期间帧已被覆盖，丢弃结果 }
+ *   }
+ */
+class SharedFrameRingReader : public SharedFrameRing {
+public:
+    struct View {
+        uint64_t sequence = 0;
+        uint64_t frame_id = 0;
+        uint64_t timestamp = 0;
+        int width = 0;
+        int height = 0;
+        int step = 0;
+        int cv_type = 0;
+        const uint8_t *data = nullptr;       // 指向共享内存，被覆盖前有效
+
+        /**
+         * @brief 直接指向共享内存的 cv::Mat（只读）
+         */
+        cv::Mat mat() const {
+            if (!data) return cv::Mat();
+
+            return cv::Mat(height, width, cv_type, const_cast<uint8_t *>(data), (size_t) step);
+        }
+    };
+
+    ~SharedFrameRingReader() {
+        close();
+    }
+
+    bool open(const std::string &name) {
+        close();
+
+        if (!map(name, false, 0)) {
+            std::cout << "Shared frame ring open error: " << name << std::endl;
+            close();
+            return false;
+        }
+
+        if (!validate()) {
+            std::cout << "Shared frame ring invalid: " << name << std::endl;
+            close();
+            return false;
+        }
+
+        // 从当前最新帧开始读取
+        m_last_sequence = latestSequence() > 0 ? latestSequence() - 1 : 0;
+        m_missed = 0;
+
+        return true;
+    }
+
+    void close() {
+        unmapWritableHeader();
+        unmap();
+    }
+
+    /**
+     * @brief 发布端是否已停止
+     */
+    bool isClosed() const {
+        return !isOpen() || header()->closed.load(std::memory_order_acquire) != 0;
+    }
+
+    /**
+     * @brief 读取指定序号的帧（不拷贝）
+     */
+    SharedFrameStatus read(uint64_t sequence, View &view) const {
+        if (!isOpen()) return SharedFrameStatus::Error;
+        if (sequence == 0 || sequence > latestSequence()) return SharedFrameStatus::Timeout;
+
+        const SharedFrameSlotHeader *s = slot(sequence);
+        uint64_t lock = s->lock.load(std::memory_order_acquire);
+        if (lock != 2 * sequence) return SharedFrameStatus::Overwritten;
+
+        view.sequence = sequence;
+        view.frame_id = s->frame_id;
+        view.timestamp = s->timestamp;
+        view.width = s->width;
+        view.height = s->height;
+        view.step = s->step;
+        view.cv_type = s->cv_type;
+        view.data = slotData(const_cast<SharedFrameSlotHeader *>(s));
+
+        // 槽头读取期间被覆盖时尺寸可能不一致
+        if (!isValid(view) || (uint64_t) view.step * (uint64_t) view.height > header()->slot_capacity) {
+            return SharedFrameStatus::Overwritten;
+        }
+
+        return SharedFrameStatus::Ok;
+    }
+
+    /**
+     * @brief 读取最新一帧，跳过中间的帧
+     */
+    SharedFrameStatus readLatest(View &view) {
+        uint64_t latest = latestSequence();
+        SharedFrameStatus status = read(latest, view);
+        if (status == SharedFrameStatus::Ok) {
+            if (latest > m_last_sequence + 1) m_missed += latest - m_last_sequence - 1;
+            m_last_sequence = latest;
+        }
+
+        return status;
+    }
+
+    /**
+     * @brief 按顺序读取下一帧，没有新帧时阻塞等待（不轮询）
+     *
+     * 滞后超过槽位数时跳到仍可读取的最旧一帧，跳过的帧计入 missedCount()。
+     */
+    SharedFrameStatus next(View &view, int timeout_ms) {
+        if (!isOpen()) return SharedFrameStatus::Error;
+
+        while (true) {
+            if (latestSequence() <= m_last_sequence) {
+                if (isClosed()) return SharedFrameStatus::Closed;
+                SharedFrameStatus status = waitSequence(m_last_sequence, timeout_ms);
+                if (status != SharedFrameStatus::Ok) return status;
+                if (latestSequence() <= m_last_sequence) return SharedFrameStatus::Closed;
+            }
+
+            uint64_t latest = latestSequence();
+            uint32_t slot_count = slotCount();
+            uint64_t oldest = latest > slot_count ? latest - slot_count + 1 : 1;
+            uint64_t wanted = std::max(m_last_sequence + 1, oldest);
+
+            // 留一个槽位的余量，避免刚读到就被覆盖
+            if (wanted == oldest && slot_count > 1 && latest >= slot_count) wanted++;
+
+            m_missed += wanted - m_last_sequence - 1;
+            m_last_sequence = wanted;
+
+            if (read(wanted, view) == SharedFrameStatus::Ok) return SharedFrameStatus::Ok;
+            m_missed++;
+        }
+    }
+
+    /**
+     * @brief 帧是否仍未被覆盖；零拷贝处理完成后调用，返回 false 时处理结果不可信
+     */
+    bool isValid(const View &view) const {
+        if (!isOpen() || view.sequence == 0) return false;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot(view.sequence)->lock.load(std::memory_order_acquire) == 2 * view.sequence;
+    }
+
+    /**
+     * @brief 拷贝一份，拷贝期间被覆盖时返回 false
+     */
+    bool copy(const View &view, cv::Mat &image) const {
+        view.mat().copyTo(image);
+
+        return isValid(view);
+    }
+
+    /**
+     * @brief 因覆盖或滞后而跳过的帧数
+     */
+    uint64_t missedCount() const {
+        return m_missed;
+    }
+
+private:
+    /**
+     * @brief 校验头部与全部槽位的布局都在映射范围内，之后按序号访问槽位不会越界
+     */
+    bool validate() const {
+        const SharedFrameRingHeader *h = header();
+        uint64_t size = (uint64_t) m_size;
+
+        if (std::memcmp(h->magic, kSharedFrameRingMagic, sizeof(h->magic)) != 0 ||
+            h->version != kSharedFrameRingVersion || h->slot_count == 0 || h->total_size > size) {
+            return false;
+        }
+        if (h->data_offset < sizeof(SharedFrameRingHeader) || h->data_offset > size ||
+            h->slot_capacity > UINT64_MAX - kSharedFrameSlotHeaderSize ||
+            h->slot_stride < kSharedFrameSlotHeaderSize + h->slot_capacity) {
+            return false;
+        }
+
+        // 以除法比较，避免损坏的字段使乘法溢出
+        return h->slot_count <= (size - h->data_offset) / h->slot_stride;
+    }
+
+    uint64_t m_last_sequence = 0;
+    uint64_t m_missed = 0;
+};
+
+
+#endif // SHARED_FRAME_RING_HPP
@@ -0,0 +1,588 @@
+#ifndef SIMULATED_CAMERA_BACKEND_HPP
+#define SIMULATED_CAMERA_BACKEND_HPP
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <sys/stat.h>
+
+#include "opencv2/opencv.hpp"
+#include "camera_backend.hpp"
+#include "frame_sequence_reader.hpp"
+#include "pixel_format.hpp"
+
+
+/**
+ * @brief 软件相机后端基类：在独立线程中按帧率（或软触发）生成帧
+ *
+ * 特征以键值表的形式保存，"AcquisitionFrameRate" 控制帧率，"TriggerMode" 为 "On" 时只在软触发后出帧。
+ * 派生类只需实现 openSource() 与 renderFrame()，需要非固定节奏时可重写 frameIntervalSec()。
+ */
+class SoftwareCameraBackend : public ICameraBackend {
+public:
+    SoftwareCameraBackend(int width, int height, double fps)
+            : m_bIsOpen(false),
+              m_bIsSnap(false),
+              m_pending_triggers(0),
+              m_frame_index(0) {
+        m_int_features["Width"] = width;
+        m_int_features["Height"] = height;
+        m_int_features["OffsetX"] = 0;
+        m_int_features["OffsetY"] = 0;
+        m_int_features["WidthMax"] = width;
+        m_int_features["HeightMax"] = height;
+        m_int_features["BinningHorizontal"] = 1;
+        m_int_features["BinningVertical"] = 1;
+        m_int_features["DecimationHorizontal"] = 1;
+        m_int_features["DecimationVertical"] = 1;
+        m_float_features["AcquisitionFrameRate"] = fps;
+        m_float_features["ExposureTime"] = 10000;
+        m_float_features["Gain"] = 0;
+        m_enum_features["AcquisitionMode"] = "Continuous";
+        m_enum_features["TriggerMode"] = "Off";
+        m_enum_features["TriggerSelector"] = "FrameStart";
+        m_enum_features["TriggerSource"] = "Software";
+        m_enum_features["ExposureAuto"] = "Off";
+        m_enum_features["PixelFormat"] = "Mono8";
+    }
+
+    ~SoftwareCameraBackend() {
+        close();
+    }
+
+    bool open() override {
+        if (m_bIsOpen) return true;
+
+        m_bIsOpen = openSource();
+        if (!m_bIsOpen) {
+            std::cout << "Open simulated device error!" << std::endl;
+        }
+
+        return m_bIsOpen;
+    }
+
+    void close() override {
+        stop();
+
+        m_bIsOpen = false;
+    }
+
+    bool start(const FrameCallback &callback) override {
+        if (!m_bIsOpen) return false;
+        if (m_bIsSnap) return true;
+
+        m_frame_callback = callback;
+        m_pending_triggers = 0;
+        m_bIsSnap = true;
+        m_thread = std::thread(&SoftwareCameraBackend::grabLoop, this);
+
+        return true;
+    }
+
+    void stop() override {
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            if (!m_bIsSnap) return;
+            m_bIsSnap = false;
+        }
+        m_cond.notify_all();
+
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    bool isOpen() const override {
+        return m_bIsOpen;
+    }
+
+    bool isGrabbing() const override {
+        return m_bIsSnap;
+    }
+
+    std::string serialNumber() const override {
+        return m_serial_number;
+    }
+
+    void setSerialNumber(const std::string &serial_number) {
+        m_serial_number = serial_number;
+    }
+
+    void enterTriggerMode() override {
+        setEnumFeature("TriggerSelector", "FrameStart");
+        setEnumFeature("TriggerSource", "Software");
+        setEnumFeature("TriggerMode", "On");
+    }
+
+    void exitTriggerMode() override {
+        setEnumFeature("TriggerSelector", "FrameStart");
+        setEnumFeature("TriggerMode", "Off");
+    }
+
+    void softwareTrigger() override {
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_pending_triggers++;
+        }
+        m_cond.notify_all();
+    }
+
+    int64_t getIntFeature(const std::string &name) override {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_int_features[name];
+    }
+
+    void setIntFeature(const std::string &name, int64_t value) override {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_int_features[name] = value;
+    }
+
+    double getFloatFeature(const std::string &name) override {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_float_features[name];
+    }
+
+    void setFloatFeature(const std::string &name, double value) override {
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_float_features[name] = value;
+        }
+        m_cond.notify_all();
+    }
+
+    std::string getEnumFeature(const std::string &name) override {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_enum_features[name];
+    }
+
+    void setEnumFeature(const std::string &name, const std::string &value) override {
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_enum_features[name] = value;
+        }
+        m_cond.notify_all();
+    }
+
+    void executeCommand(const std::string &name) override {
+        if (name == "TriggerSoftware") softwareTrigger();
+    }
+
+    bool hasFeature(const std::string &name) override {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        return m_int_features.count(name) || m_float_features.count(name) || m_enum_features.count(name);
+    }
+
+    /**
+     * @brief 模拟传感器的几何约束：宽高不超过按合并/抽点缩小后的最大尺寸，偏移不使区域越界
+     */
+    bool getIntFeatureRange(const std::string &name, int64_t &min, int64_t &max, int64_t &inc) override {
+        std::lock_guard<std::mutex> locker(m_mutex);
+
+        int64_t scale_x = std::max<int64_t>(1, m_int_features["BinningHorizontal"] * m_int_features["DecimationHorizontal"]);
+        int64_t scale_y = std::max<int64_t>(1, m_int_features["BinningVertical"] * m_int_features["DecimationVertical"]);
+        int64_t width_max = m_int_features["WidthMax"] / scale_x;
+        int64_t height_max = m_int_features["HeightMax"] / scale_y;
+
+        inc = 1;
+        if (name == "Width") {
+            min = 1;
+            max = width_max - m_int_features["OffsetX"];
+        } else if (name == "Height") {
+            min = 1;
+            max = height_max - m_int_features["OffsetY"];
+        } else if (name == "OffsetX") {
+            min = 0;
+            max = width_max - m_int_features["Width"];
+        } else if (name == "OffsetY") {
+            min = 0;
+            max = height_max - m_int_features["Height"];
+        } else if (name.compare(0, 7, "Binning") == 0 || name.compare(0, 10, "Decimation") == 0) {
+            min = 1;
+            max = 4;
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+
+protected:
+    /**
+     * @brief 打开帧源，可在此处修改 Width/Height 特征
+     */
+    virtual bool openSource() = 0;
+
+    /**
+     * @brief 生成第 index 帧
+     *
+     * buffer 已按 PixelFormat 特征对应的原始帧大小分配，frame 已预填为指向 buffer 的数据、自增帧号与当前时间戳；
+     * 派生类可将 frame.data 指向自己的内存以避免拷贝，也可改写帧号与时间戳。
+     *
+     * @return 是否成功生成
+     */
+    virtual bool renderFrame(uint64_t index, int width, int height, std::vector<uint8_t> &buffer, RawFrame &frame) = 0;
+
+    /**
+     * @brief 第 index 帧与上一帧之间的间隔（秒），<= 0 表示不等待，默认由 AcquisitionFrameRate 决定
+     */
+    virtual double frameIntervalSec(uint64_t index, double fps) {
+        return fps > 0 ? 1.0 / fps : 0;
+    }
+
+    /**
+     * @brief 第 index 帧是否已超出帧源末尾（不循环回放时），到达末尾后生成线程不再出帧，直到停止采集
+     */
+    virtual bool atEndOfStream(uint64_t index) {
+        return false;
+    }
+
+private:
+    static constexpr int kRetryIntervalMs = 100;
+
+    void grabLoop() {
+        using clock = std::chrono::steady_clock;
+
+        auto next_time = clock::now();
+
+        while (true) {
+            int width, height;
+            size_t raw_size;
+            {
+                std::unique_lock<std::mutex> locker(m_mutex);
+
+                if (m_enum_features["TriggerMode"] == "On") {
+                    m_cond.wait(locker, [this]() {
+                        return !m_bIsSnap || m_pending_triggers > 0 || m_enum_features["TriggerMode"] != "On";
+                    });
+                    if (!m_bIsSnap) break;
+                    if (m_pending_triggers > 0) m_pending_triggers--;
+                    next_time = clock::now();
+                } else {
+                    double interval = frameIntervalSec(m_frame_index, m_float_features["AcquisitionFrameRate"]);
+                    if (interval > 0) {
+                        next_time += std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(interval));
+                        m_cond.wait_until(locker, next_time, [this]() { return !m_bIsSnap; });
+
+                        // 生成速度跟不上时不累积欠账
+                        if (next_time < clock::now()) next_time = clock::now();
+                    }
+                    if (!m_bIsSnap) break;
+                }
+
+                width = (int) m_int_features["Width"];
+                height = (int) m_int_features["Height"];
+                raw_size = pixelFormatRawSize(pixelFormatFromName(m_enum_features["PixelFormat"]), width, height);
+            }
+
+            m_buffer.resize(raw_size);
+
+            RawFrame frame;
+            frame.data = m_buffer.data();
+            frame.size = m_buffer.size();
+            frame.width = width;
+            frame.height = height;
+            frame.frame_id = m_frame_index + 1;
+            frame.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    clock::now().time_since_epoch()).count();
+
+            if (!renderFrame(m_frame_index, width, height, m_buffer, frame)) {
+                std::unique_lock<std::mutex> locker(m_mutex);
+
+                if (atEndOfStream(m_frame_index)) {
+                    m_cond.wait(locker, [this]() { return !m_bIsSnap; });
+                    break;
+                }
+
+                // 生成失败（如图像尺寸不符）时限制重试频率
+                m_cond.wait_for(locker, std::chrono::milliseconds(kRetryIntervalMs), [this]() { return !m_bIsSnap; });
+                next_time = clock::now();
+                continue;
+            }
+            m_frame_index++;
+
+            if (m_frame_callback) m_frame_callback(frame);
+        }
+    }
+
+private:
+    std::string m_serial_number;
+
+    std::atomic<bool> m_bIsOpen;
+    std::atomic<bool> m_bIsSnap;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    int m_pending_triggers;
+
+    std::map<std::string, int64_t> m_int_features;
+    std::map<std::string, double> m_float_features;
+    std::map<std::string, std::string> m_enum_features;
+
+    FrameCallback m_frame_callback;
+    std::thread m_thread;
+    std::vector<uint8_t> m_buffer;
+    uint64_t m_frame_index;
+};
+
+
+/**
+ * @brief 合成图像后端：按给定分辨率与帧率生成移动的渐变图
+ *
+ * 渐变按原始字节生成，任何 PixelFormat 下都能得到有效的帧，可用于测试格式转换链路。
+ */
+class SyntheticCameraBackend : public SoftwareCameraBackend {
+public:
+    SyntheticCameraBackend(int width = 1920, int height = 1080, double fps = 30)
+            : SoftwareCameraBackend(width, height, fps) {
+        setSerialNumber("SIM-SYNTHETIC");
+    }
+
+    ~SyntheticCameraBackend() {
+        close();
+    }
+
+protected:
+    bool openSource() override {
+        return true;
+    }
+
+    bool renderFrame(uint64_t index, int width, int height, std::vector<uint8_t> &buffer, RawFrame &) override {
+        // 预生成两倍宽的渐变行，每行按偏移整行拷贝，生成开销接近一次 memcpy
+        size_t row_bytes = buffer.size() / (size_t) height;
+        if (m_pattern.size() != row_bytes * 2) {
+            m_pattern.resize(row_bytes * 2);
+            for (size_t x = 0; x < row_bytes * 2; x++) {
+                m_pattern[x] = (uint8_t) (x & 0xFF);
+            }
+        }
+
+        for (int y = 0; y < height; y++) {
+            size_t offset = (size_t) ((index * 4 + y) % (uint64_t) row_bytes);
+            std::memcpy(buffer.data() + (size_t) y * row_bytes, m_pattern.data() + offset, row_bytes);
+        }
+
+        return true;
+    }
+
+private:
+    std::vector<uint8_t> m_pattern;
+};
+
+
+/**
+ * @brief 回放后端：按帧率循环回放目录中的图像，或固定尺寸的 8 位原始帧文件
+ *
+ * 图像尺寸由源数据决定，不支持修改 ROI、合并与抽点。
+ */
+class ReplayCameraBackend : public SoftwareCameraBackend {
+public:
+    /**
+     * @param path - 图像目录，或原始帧文件（逐帧连续存放的 width * height 字节）
+     * @param fps - 回放帧率
+     * @param raw_width - 原始帧文件的图像宽度，回放目录时忽略
+     * @param raw_height - 原始帧文件的图像高度，回放目录时忽略
+     * @param loop - 是否循环回放
+     */
+    ReplayCameraBackend(std::string path, double fps = 30, int raw_width = 0, int raw_height = 0, bool loop = true)
+            : SoftwareCameraBackend(raw_width, raw_height, fps),
+              m_path(std::move(path)),
+              m_loop(loop),
+              m_frame_count(0) {
+        setSerialNumber("SIM-REPLAY");
+    }
+
+    ~ReplayCameraBackend() {
+        close();
+    }
+
+protected:
+    bool openSource() override {
+        m_files.clear();
+        m_frame_count = 0;
+
+        // 部分平台上目录也能以 ifstream 打开，tellg() 返回无意义的大数，需先排除目录
+        struct stat st;
+        if (stat(m_path.c_str(), &st) != 0) return false;
+        bool is_directory = (st.st_mode & S_IFMT) == S_IFDIR;
+
+        if (!is_directory) {
+            // 原始帧文件
+            std::ifstream raw_file(m_path, std::ios::binary | std::ios::ate);
+            if (!raw_file.is_open() || raw_file.tellg() <= 0) return false;
+
+            int64_t frame_size = getIntFeature("Width") * getIntFeature("Height");
+            if (frame_size <= 0) return false;
+
+            m_frame_count = (uint64_t) raw_file.tellg() / frame_size;
+            raw_file.close();
+
+            m_raw_file.open(m_path, std::ios::binary);
+            return m_frame_count > 0 && m_raw_file.is_open();
+        }
+
+        // 图像目录
+        std::vector<std::string> files;
+        cv::glob(m_path + "/*", files, false);
+        std::sort(files.begin(), files.end());
+        for (const auto &file : files) {
+            cv::Mat image = cv::imread(file, cv::IMREAD_GRAYSCALE);
+            if (image.empty()) continue;
+
+            if (m_files.empty()) {
+                setIntFeature("Width", image.cols);
+                setIntFeature("Height", image.rows);
+                setIntFeature("WidthMax", image.cols);
+                setIntFeature("HeightMax", image.rows);
+            }
+            m_files.push_back(file);
+        }
+        m_frame_count = m_files.size();
+
+        return m_frame_count > 0;
+    }
+
+    bool atEndOfStream(uint64_t index) override {
+        return !m_loop && index >= m_frame_count;
+    }
+
+    bool renderFrame(uint64_t index, int width, int height, std::vector<uint8_t> &buffer, RawFrame &) override {
+        if (m_frame_count == 0) return false;
+        if (!m_loop && index >= m_frame_count) return false;
+
+        uint64_t n = index % m_frame_count;
+
+        if (m_files.empty()) {
+            m_raw_file.clear();
+            m_raw_file.seekg((std::streamoff) (n * buffer.size()));
+            return (bool) m_raw_file.read(reinterpret_cast<char *>(buffer.data()), (std::streamsize) buffer.size());
+        }
+
+        cv::Mat image = cv::imread(m_files[n], cv::IMREAD_GRAYSCALE);
+        if (image.rows != height || image.cols != width) return false;
+
+        cv::Mat view(height, width, CV_8UC1, buffer.data());
+        image.copyTo(view);
+
+        return true;
+    }
+
+private:
+    std::string m_path;
+    bool m_loop;
+
+    std::vector<std::string> m_files;
+    std::ifstream m_raw_file;
+    uint64_t m_frame_count;
+};
+
+
+/**
+ * @brief 帧序列回放后端：内存映射帧序列文件（FrameRecorder 录制），零拷贝地按原始节奏或倍速回放
+ *
+ * 帧号与 SDK 时间戳沿用录制时的值，可替代实时相机供 VideoWidget 与算法离线分析、压测。
+ * 图像尺寸由录制文件决定，不支持修改 ROI、合并与抽点。
+ */
+class SequenceCameraBackend : public SoftwareCameraBackend {
+public:
+    /**
+     * @param path - 帧序列文件路径
+     * @param speed - 回放倍速，1 为原始节奏，<= 0 为不限速
+     * @param loop - 是否循环回放
+     * @param prefetch_frames - 顺序预读的帧数
+     */
+    SequenceCameraBackend(std::string path, double speed = 1.0, bool loop = true, uint64_t prefetch_frames = 8)
+            : SoftwareCameraBackend(0, 0, 0),
+              m_path(std::move(path)),
+              m_speed(speed),
+              m_loop(loop),
+              m_prefetch_frames(prefetch_frames) {
+        setSerialNumber("SIM-SEQUENCE");
+    }
+
+    ~SequenceCameraBackend() {
+        close();
+    }
+
+    const FrameSequenceReader &reader() const {
+        return m_reader;
+    }
+
+protected:
+    bool openSource() override {
+        if (!m_reader.open(m_path) || m_reader.frameCount() == 0) return false;
+
+        // 录制的是转换后的帧，按对应的直通格式回放，要求行间无填充
+        PixelFormat format;
+        switch (m_reader.header()->cv_type) {
+            case CV_8UC1: format = PixelFormat::Mono8; break;
+            case CV_16UC1: format = PixelFormat::Mono16; break;
+            case CV_8UC3: format = PixelFormat::RGB8; break;
+            default: return false;
+        }
+        if (m_reader.header()->step != m_reader.width() * pixelFormatOutputBytesPerPixel(format)) return false;
+
+        setEnumFeature("PixelFormat", pixelFormatName(format));
+        setIntFeature("Width", m_reader.width());
+        setIntFeature("Height", m_reader.height());
+        setIntFeature("WidthMax", m_reader.width());
+        setIntFeature("HeightMax", m_reader.height());
+        m_reader.adviseSequential();
+        m_reader.prefetch(0, m_prefetch_frames);
+
+        return true;
+    }
+
+    bool atEndOfStream(uint64_t index) override {
+        return !m_loop && index >= m_reader.frameCount();
+    }
+
+    bool renderFrame(uint64_t index, int width, int height, std::vector<uint8_t> &, RawFrame &frame) override {
+        uint64_t count = m_reader.frameCount();
+        if (count == 0 || width != m_reader.width() || height != m_reader.height()) return false;
+        if (!m_loop && index >= count) return false;
+
+        uint64_t n = index % count;
+        const FrameSequenceIndexEntry &entry = m_reader.entry(n);
+
+        frame.data = m_reader.frameData(n);
+        frame.size = (size_t) m_reader.header()->frame_size;
+        frame.frame_id = entry.frame_id;
+        frame.timestamp = entry.timestamp;
+
+        // 预读窗口每推进半个窗口发起一次
+        if (m_prefetch_frames > 0 && n % std::max<uint64_t>(1, m_prefetch_frames / 2) == 0) {
+            m_reader.prefetch(n + 1, m_prefetch_frames);
+        }
+
+        return true;
+    }
+
+    double frameIntervalSec(uint64_t index, double) override {
+        uint64_t count = m_reader.frameCount();
+        if (m_speed <= 0 || count < 2) return 0;
+
+        uint64_t n = index % count;
+        if (n == 0) return 0;
+
+        uint64_t delta_ns = m_reader.entry(n).host_ns - m_reader.entry(n - 1).host_ns;
+        return (double) delta_ns / 1e9 / m_speed;
+    }
+
+private:
+    std::string m_path;
+    double m_speed;
+    bool m_loop;
+    uint64_t m_prefetch_frames;
+
+    FrameSequenceReader m_reader;
+};
+
+
+#endif // SIMULATED_CAMERA_BACKEND_HPP
@@ -0,0 +1,83 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief 有界单生产者单消费者无锁队列
+ *
+ * tryPush() / tryPop() 都不会阻塞，队列满时 tryPush() 直接返回 false，由调用方决定丢弃策略。
+ */
+template<typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity = 16)
+            : m_slots(capacity + 1),
+              m_head(0),
+              m_tail(0) {}
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    /**
+     * @brief 重新设置容量，只能在生产者和消费者都空闲时调用
+     */
+    void reset(size_t capacity) {
+        m_slots.assign(capacity + 1, T());
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const {
+        return m_slots.size() - 1;
+    }
+
+    size_t size() const {
+        size_t head = m_head.load(std::memory_order_acquire);
+        size_t tail = m_tail.load(std::memory_order_acquire);
+
+        return (tail + m_slots.size() - head) % m_slots.size();
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    // ---------- 生产者 ----------
+
+    bool tryPush(T value) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) % m_slots.size();
+        if (next == m_head.load(std::memory_order_acquire)) return false;
+
+        m_slots[tail] = std::move(value);
+        m_tail.store(next, std::memory_order_release);
+
+        return true;
+    }
+
+    // ---------- 消费者 ----------
+
+    bool tryPop(T &value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+
+        value = std::move(m_slots[head]);
+        m_slots[head] = T();  // 尽早释放资源（如帧句柄）
+        m_head.store((head + 1) % m_slots.size(), std::memory_order_release);
+
+        return true;
+    }
+
+private:
+    std::vector<T> m_slots;
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+};
+
+
+#endif // SPSC_QUEUE_HPP
@@ -0,0 +1,148 @@
+#ifndef TRIGGER_MATCHER_HPP
+#define TRIGGER_MATCHER_HPP
+
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+
+#include "frame_metrics.hpp"
+#include "frame_pool.hpp"
+
+
+/**
+ * @brief 软触发与帧的匹配
+ *
+ * 触发模式下每次触发产生一帧，SDK 帧号逐帧递增。每次触发前登记期望的帧号
+ * （上一帧帧号与上一次登记的帧号中较大者 + 1），帧到达时按帧号完成对应的 promise：
+ * 帧号相等则交付该帧，帧号已越过（SDK 丢帧）或超时则交付空句柄。
+ *
+ * 注意：绕过本类直接发送的软触发也会产生帧，会使之后的匹配错位；CameraController 的软触发均经过本类。
+ * 进入触发模式时以 reset(fence_ns) 设置界限，之前回调的帧（连续采集时残留在队列中的帧）不参与匹配。
+ */
+class TriggerMatcher {
+public:
+    TriggerMatcher()
+            : m_pending_count(0),
+              m_last_frame_id(0),
+              m_has_last_frame_id(false),
+              m_last_target(0),
+              m_fence_ns(0) {}
+
+    /**
+     * @brief 登记一次触发，必须在真正发送触发命令之前调用
+     */
+    std::future<FrameRef> addTrigger(int timeout_ms) {
+        std::lock_guard<std::mutex> locker(m_mutex);
+
+        Pending pending;
+        pending.trigger_ns = FrameMetrics::now();
+        pending.deadline_ns = pending.trigger_ns + (uint64_t) std::max(timeout_ms, 0) * 1000000ull;
+        pending.any_frame = !m_has_last_frame_id.load(std::memory_order_acquire) && m_pending.empty();
+        pending.target_frame_id = std::max(m_last_frame_id.load(std::memory_order_acquire), m_last_target) + 1;
+        m_last_target = pending.target_frame_id;
+
+        expire(pending.trigger_ns);
+
+        std::future<FrameRef> future = pending.promise.get_future();
+        m_pending.push_back(std::move(pending));
+        m_pending_count.store(m_pending.size(), std::memory_order_release);
+
+        return future;
+    }
+
+    /**
+     * @brief 由采集线程对每一帧调用，frame 为空表示该帧已被丢弃
+     */
+    void onFrame(uint64_t frame_id, const FrameRef &frame, uint64_t callback_ns, FrameMetrics &metrics) {
+        if (callback_ns < m_fence_ns.load(std::memory_order_acquire)) return;
+
+        m_last_frame_id.store(frame_id, std::memory_order_release);
+        m_has_last_frame_id.store(true, std::memory_order_release);
+
+        // 连续采集时没有等待中的触发，不加锁
+        if (m_pending_count.load(std::memory_order_acquire) == 0) return;
+
+        std::lock_guard<std::mutex> locker(m_mutex);
+
+        while (!m_pending.empty()) {
+            Pending &pending = m_pending.front();
+
+            if (pending.any_frame) {
+                // 首次登记时还没有收到过帧，以首帧为准并重新推算后续触发的帧号
+                uint64_t shift = frame_id - pending.target_frame_id;
+                for (auto &other : m_pending) {
+                    other.target_frame_id += shift;
+                    other.any_frame = false;
+                }
+                m_last_target += shift;
+            }
+
+            if (pending.target_frame_id > frame_id) break;
+
+            if (pending.target_frame_id == frame_id) {
+                metrics.recordTrigger(callback_ns - pending.trigger_ns);
+                pending.promise.set_value(frame);
+            } else {
+                // 期望的帧已丢失
+                pending.promise.set_value(FrameRef());
+            }
+            m_pending.pop_front();
+        }
+
+        expire(callback_ns);
+        m_pending_count.store(m_pending.size(), std::memory_order_release);
+    }
+
+    /**
+     * @brief 取消所有未完成的触发（停止采集时调用），并重新开始帧号跟踪
+     * @param fence_ns - 回调时间早于此时刻的帧之后不再参与匹配，0 表示不限制
+     */
+    void reset(uint64_t fence_ns = 0) {
+        std::lock_guard<std::mutex> locker(m_mutex);
+
+        m_fence_ns.store(fence_ns, std::memory_order_release);
+
+        for (auto &pending : m_pending) {
+            pending.promise.set_value(FrameRef());
+        }
+        m_pending.clear();
+        m_pending_count.store(0, std::memory_order_release);
+
+        m_last_frame_id.store(0, std::memory_order_relaxed);
+        m_has_last_frame_id.store(false, std::memory_order_relaxed);
+        m_last_target = 0;
+    }
+
+private:
+    struct Pending {
+        uint64_t target_frame_id = 0;
+        bool any_frame = false;
+        uint64_t trigger_ns = 0;
+        uint64_t deadline_ns = 0;
+        std::promise<FrameRef> promise;
+    };
+
+    // 调用方持有 m_mutex
+    void expire(uint64_t now_ns) {
+        while (!m_pending.empty() && m_pending.front().deadline_ns < now_ns) {
+            m_pending.front().promise.set_value(FrameRef());
+            m_pending.pop_front();
+        }
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<Pending> m_pending;
+    std::atomic<size_t> m_pending_count;
+
+    std::atomic<uint64_t> m_last_frame_id;   // 采集线程写入，登记触发时读取
+    std::atomic<bool> m_has_last_frame_id;
+    uint64_t m_last_target;                  // 最近一次登记的帧号，m_mutex 保护
+    std::atomic<uint64_t> m_fence_ns;        // 早于此回调时间的帧被忽略
+};
+
+
+#endif // TRIGGER_MATCHER_HPP
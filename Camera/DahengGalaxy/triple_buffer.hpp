@@ -0,0 +1,92 @@
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+
+/**
+ * @brief 无锁三缓冲
+ *
+ * 写端始终写入空闲的后台缓冲区，发布时与中间缓冲区交换；读端取用时再与中间缓冲区交换，
+ * 因此读端总能拿到最新的一帧完整数据，且写端和读端都不会互相等待。
+ *
+ * 注意：写端和读端各只能有一个线程，多个读线程需要在读端自行串行化。
+ */
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer()
+            : m_write_index(0),
+              m_middle(1),
+              m_read_index(2) {}
+
+    ~TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    /**
+     * @brief 对三个缓冲区执行相同的初始化操作，只能在读写两端都空闲时调用
+     */
+    template<typename Func>
+    void forEach(Func func) {
+        for (auto &buffer : m_buffers) {
+            func(buffer);
+        }
+    }
+
+    /**
+     * @brief 清除未读标志，只能在读写两端都空闲时调用
+     */
+    void reset() {
+        m_middle.store(m_middle.load(std::memory_order_relaxed) & kIndexMask, std::memory_order_relaxed);
+    }
+
+    // ---------- 写端 ----------
+
+    T &writeBuffer() {
+        return m_buffers[m_write_index];
+    }
+
+    void publish() {
+        uint8_t prev = m_middle.exchange(static_cast<uint8_t>(m_write_index | kDirtyBit), std::memory_order_acq_rel);
+        m_write_index = prev & kIndexMask;
+    }
+
+    // ---------- 读端 ----------
+
+    bool hasNewData() const {
+        return (m_middle.load(std::memory_order_acquire) & kDirtyBit) != 0;
+    }
+
+    /**
+     * @brief 若有新数据则将其换到读缓冲区
+     * @return 是否取到了新数据
+     */
+    bool update() {
+        if (!hasNewData()) return false;
+
+        uint8_t prev = m_middle.exchange(m_read_index, std::memory_order_acq_rel);
+        m_read_index = prev & kIndexMask;
+
+        return true;
+    }
+
+    const T &readBuffer() const {
+        return m_buffers[m_read_index];
+    }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x03;
+    static constexpr uint8_t kDirtyBit = 0x04;
+
+    T m_buffers[3];
+
+    uint8_t m_write_index;  // 仅写端访问
+    alignas(64) std::atomic<uint8_t> m_middle;  // 中间缓冲区索引 + 未读标志
+    alignas(64) uint8_t m_read_index;  // 仅读端访问
+};
+
+
+#endif // TRIPLE_BUFFER_HPP
@@ -4,50 +4,765 @@
 #define VIDEO_WIDGET_HPP
 
 #include <QOpenGLWidget>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QElapsedTimer>
 #include <QImage>
+#include <QMouseEvent>
 #include <QPainter>
+#include <QScreen>
+#include <QTimer>
+#include <QWheelEvent>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "camera_controller.h"
+#include "overlay_layer.hpp"
 
 
-class VideoWidget : public QOpenGLWidget {
+/**
+ * @brief 视频显示控件
+ *
+ * 收到的帧只保存最新一帧（不做任何图像处理），由按显示刷新率运行的定时器决定是否重绘，
+ * 采集帧率高于刷新率时多余的帧被合并。
+ *
+ * 两种绘制方式：
+ *   Painter - QPainter 在 CPU 上缩放，缩放结果缓存到下一帧或控件尺寸改变；
+ *   Texture - 每个新帧整幅上传到与帧同尺寸的常驻纹理（尺寸不变时只做 glTexSubImage2D），
+ *             缩放、平移与留黑边只改变视口与纹理坐标，缩小由 GL 过滤完成（支持时使用 mipmap），不重新上传。
+ * Texture 方式只使用 OpenGL ES 2.0 / 桌面 GL 2.1 的功能（mipmap 需要 GL 3.0 / ES 3.0 或 FBO 扩展），
+ * 可在 Mesa llvmpipe 等软件实现上运行；当前上下文无法上传的格式（如 OpenGL ES 下的 16 位灰度）
+ * 或超过最大纹理尺寸的帧自动退回 Painter 方式。
+ *
+ * 支持缩放与平移（滚轮以光标为中心缩放，左键拖动平移，双击在适应窗口与 1:1 之间切换）。
+ * Painter 方式缩小显示时从按需生成的图像金字塔中选取不低于屏幕分辨率的最小一层，且只处理可见区域，
+ * 高分辨率帧全速到达时缩放、平移仍然流畅。金字塔随每一显示帧重建，只生成用到的层。
+ *
+ * 叠加图元（十字线、ROI、匹配框、比例尺等）通过 overlayLayer() 以图像坐标注册，
+ * 缓存为一张透明图像，在视频之上用 QPainter 合成。
+ */
+class VideoWidget : public QOpenGLWidget, protected QOpenGLFunctions {
     Q_OBJECT
 
 public:
-    explicit VideoWidget(QWidget *parent = nullptr)
-            : QOpenGLWidget(parent) {
-        auto &camera = CameraController::getInstance();
-        connect(&camera, &CameraController::signalUpdateImage, this, &VideoWidget::slotUpdateImage);
+    enum class RenderMode {
+        Painter,
+        Texture,
+    };
+
+    struct RenderBenchmarkResult {
+        int frames = 0;
+        double painter_ms_per_frame = 0;
+        double texture_ms_per_frame = 0;
+    };
+
+    /**
+     * @param camera - 显示的相机，为空时使用 CameraController::getInstance()
+     */
+    explicit VideoWidget(QWidget *parent = nullptr, CameraController *camera = nullptr)
+            : QOpenGLWidget(parent),
+              m_camera(nullptr),
+              m_scaled_level(-1),
+              m_view_scale(0),
+              m_dragging(false),
+              m_has_pending(false),
+              m_frame_painted(true),
+              m_smooth_scaling(false),
+              m_render_mode(RenderMode::Texture),
+              m_gl_initialized(false),
+              m_texture(0),
+              m_texture_width(0),
+              m_texture_height(0),
+              m_texture_format(0),
+              m_texture_type(0),
+              m_texture_dirty(false),
+              m_use_mipmaps(false),
+              m_max_texture_size(0),
+              m_display_rate(0),
+              m_frames_received(0),
+              m_frames_painted(0) {
+        setCamera(camera ? camera : &CameraController::getInstance());
+
+        m_display_timer.setTimerType(Qt::PreciseTimer);
+        connect(&m_display_timer, &QTimer::timeout, this, &VideoWidget::onDisplayTick);
+        m_display_timer.start(displayIntervalMsec());
+
+        m_overlay.setChangedCallback([this]() {
+            update();
+        });
+    }
+
+    ~VideoWidget() {
+        if (m_gl_initialized) {
+            makeCurrent();
+            if (m_texture) glDeleteTextures(1, &m_texture);
+            m_program.reset();
+            doneCurrent();
+        }
+    }
+
+    void setCamera(CameraController *camera) {
+        if (m_camera) disconnect(m_camera, nullptr, this, nullptr);
+
+        m_camera = camera;
+        m_frame.reset();
+        m_image = QImage();
+        m_scaled_image = QImage();
+        m_pyramid.clear();
+        m_pending_frame.reset();
+        m_pending_image = QImage();
+        m_has_pending = false;
+
+        if (m_camera) connect(m_camera, &CameraController::signalUpdateFrame, this, &VideoWidget::slotUpdateFrame);
+    }
+
+    /**
+     * @brief 设置最高重绘频率，<= 0 时使用屏幕刷新率
+     */
+    void setDisplayRate(double fps) {
+        m_display_rate = fps;
+        m_display_timer.start(displayIntervalMsec());
+    }
+
+    /**
+     * @brief 缩放时是否使用平滑插值（大幅缩小时开销明显更高），默认关闭
+     */
+    void setSmoothScaling(bool smooth) {
+        m_smooth_scaling = smooth;
+        m_scaled_image = QImage();
+        update();
+    }
+
+    /**
+     * @brief 设置缩放比例（控件像素 / 图像像素），1 为 1:1；小于等于适应窗口的比例时恢复适应窗口
+     */
+    void setZoom(double zoom) {
+        zoomAt(QPointF(width() / 2.0, height() / 2.0), zoom);
+    }
+
+    /**
+     * @brief 当前的缩放比例（适应窗口时为实际显示比例）
+     */
+    double getZoom() const {
+        return m_view_scale > 0 ? m_view_scale : fitScale();
+    }
+
+    void zoomToFit() {
+        m_view_scale = 0;
+        viewChanged();
+    }
+
+    void zoomToActualSize() {
+        setZoom(1.0);
+    }
+
+    bool isFitToWindow() const {
+        return m_view_scale <= 0;
+    }
+
+    /**
+     * @brief 以 widget_pos（控件坐标）下的图像点为不动点缩放
+     */
+    void zoomAt(const QPointF &widget_pos, double zoom) {
+        if (m_image.isNull() || zoom <= fitScale()) {
+            zoomToFit();
+            return;
+        }
+
+        QPointF anchor = widgetToImage(widget_pos);
+        m_view_scale = std::min(zoom, kMaxZoom);
+        m_view_center = clampViewCenter(anchor - (widget_pos - QPointF(width() / 2.0, height() / 2.0)) / m_view_scale);
+        viewChanged();
+    }
+
+    /**
+     * @brief 设置显示中心（图像坐标），适应窗口时无效
+     */
+    void setViewCenter(const QPointF &center) {
+        if (m_view_scale <= 0) return;
+
+        m_view_center = clampViewCenter(center);
+        viewChanged();
+    }
+
+    QPointF widgetToImage(const QPointF &widget_pos) const {
+        return imageToWidgetTransform().inverted().map(widget_pos);
+    }
+
+    QPointF imageToWidget(const QPointF &image_pos) const {
+        return imageToWidgetTransform().map(image_pos);
+    }
+
+    /**
+     * @brief 叠加层，图元使用图像像素坐标，修改后控件自动重绘
+     */
+    OverlayLayer &overlayLayer() {
+        return m_overlay;
+    }
+
+    void setRenderMode(RenderMode mode) {
+        m_render_mode = mode;
+        m_scaled_image = QImage();
+        m_texture_dirty = true;
+        update();
+    }
+
+    RenderMode getRenderMode() const {
+        return m_render_mode;
+    }
+
+    /**
+     * @brief 对比两种绘制方式的单帧耗时（每帧都视为新帧：Painter 重新缩放，Texture 重新上传）
+     *
+     * 同步调用 paintGL() 并以 glFinish() 等待 GL 完成。控件无需显示，例如无界面环境下使用
+     * QT_QPA_PLATFORM=offscreen 与 LIBGL_ALWAYS_SOFTWARE=1（llvmpipe）运行。
+     * 命令行程序见 render_benchmark.cpp。
+     *
+     * @param image - 测试图像，为空时使用当前帧
+     */
+    RenderBenchmarkResult benchmarkRender(const QImage &image = QImage(), int frames = 200) {
+        RenderBenchmarkResult result;
+        result.frames = frames;
+
+        QImage test_image = image.isNull() ? m_image : image;
+        if (test_image.isNull() || frames <= 0) return result;
+
+        // 控件未显示时由 grabFramebuffer() 完成 GL 初始化
+        if (!m_gl_initialized) grabFramebuffer();
+        if (!m_gl_initialized) return result;
+
+        RenderMode previous_mode = m_render_mode;
+        FrameRef previous_frame = m_frame;
+        QImage previous_image = m_image;
+        bool previous_painted = m_frame_painted;
+
+        auto run = [&](RenderMode mode) -> double {
+            m_render_mode = mode;
+            m_image = test_image;
+            m_frame.reset();
+            m_frame_painted = true;
+
+            makeCurrent();
+            QElapsedTimer timer;
+            timer.start();
+            for (int i = 0; i < frames; i++) {
+                m_scaled_image = QImage();
+                m_pyramid.clear();
+                m_texture_dirty = true;
+                paintGL();
+            }
+            glFinish();
+            double ms = (double) timer.nsecsElapsed() / 1e6 / frames;
+            doneCurrent();
+
+            return ms;
+        };
+
+        result.painter_ms_per_frame = run(RenderMode::Painter);
+        result.texture_ms_per_frame = run(RenderMode::Texture);
+
+        m_render_mode = previous_mode;
+        m_frame = previous_frame;
+        m_image = previous_image;
+        m_frame_painted = previous_painted;
+        m_scaled_image = QImage();
+        m_pyramid.clear();
+        m_texture_dirty = true;
+        update();
+
+        return result;
     }
 
-    ~VideoWidget() = default;
+    /**
+     * @brief 收到的帧数（包括被合并掉的帧）
+     */
+    uint64_t getFramesReceived() const {
+        return m_frames_received;
+    }
+
+    /**
+     * @brief 实际绘制的帧数，同一帧多次重绘只计一次
+     */
+    uint64_t getFramesPainted() const {
+        return m_frames_painted;
+    }
+
+    void resetFrameCounters() {
+        m_frames_received = 0;
+        m_frames_painted = 0;
+    }
 
 public slots:
-    void paintEvent(QPaintEvent *event) override {
-        Q_UNUSED(event);
+    void initializeGL() override {
+        initializeOpenGLFunctions();
+
+        m_program.reset(new QOpenGLShaderProgram());
+        m_program->addShaderFromSourceCode(QOpenGLShader::Vertex,
+            "attribute vec2 a_position;\n"
+            "attribute vec2 a_texcoord;\n"
+            "varying vec2 v_texcoord;\n"
+            "void main() {\n"
+            "    v_texcoord = a_texcoord;\n"
+            "    gl_Position = vec4(a_position, 0.0, 1.0);\n"
+            "}\n");
+        m_program->addShaderFromSourceCode(QOpenGLShader::Fragment,
+            "#ifdef GL_ES\n"
+            "precision mediump float;\n"
+            "#endif\n"
+            "uniform sampler2D u_texture;\n"
+            "varying vec2 v_texcoord;\n"
+            "void main() {\n"
+            "    gl_FragColor = vec4(texture2D(u_texture, v_texcoord).rgb, 1.0);\n"
+            "}\n");
+        m_program->bindAttributeLocation("a_position", 0);
+        m_program->bindAttributeLocation("a_texcoord", 1);
+        if (!m_program->link()) {
+            std::cout << "VideoWidget shader link error: " << m_program->log().toStdString() << std::endl;
+            m_program.reset();
+        }
+
+        // glGenerateMipmap 需要 GL 3.0 / ES 3.0 或 FBO 扩展；ES 2.0 的非 2 次幂纹理不支持 mipmap
+        QOpenGLContext *gl_context = context();
+        m_use_mipmaps = gl_context && (gl_context->format().majorVersion() >= 3 ||
+                                       (!gl_context->isOpenGLES() &&
+                                        gl_context->hasExtension("GL_ARB_framebuffer_object")));
+        GLint max_texture_size = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+        m_max_texture_size = max_texture_size;
+
+        m_texture = 0;
+        m_texture_width = m_texture_height = 0;
+        m_texture_dirty = true;
+        m_gl_initialized = true;
+    }
+
+    // QOpenGLWidget 的绘制入口，QPainter 与 GL 都绘制到控件的帧缓冲
+    void paintGL() override {
+        if (!m_image.isNull() && m_render_mode == RenderMode::Texture && paintTexture()) {
+            markFramePainted();
+
+            if (!m_overlay.isEmpty()) {
+                QPainter painter(this);
+                paintOverlay(painter);
+            }
+            return;
+        }
 
         QPainter painter(this);
         painter.fillRect(rect(), Qt::black);
 
         if (!m_image.isNull()) {
-            // 计算图像绘制区域（保持长宽比，居中）并绘制图像
-            QRect image_rect = calculateImageRect();
-            painter.drawImage(image_rect, m_image);
+            // 只缩放可见区域，缩放结果缓存到下一帧、视图或尺寸改变
+            ViewRegion region = computeViewRegion();
+            if (region.valid) {
+                QSize target_size((int) std::lround(region.target.width()), (int) std::lround(region.target.height()));
+                if (m_scaled_image.isNull() || m_scaled_image.size() != target_size ||
+                    m_scaled_level != region.level || m_scaled_source != region.source) {
+                    QImage visible = region.source == region.image.rect() ? region.image : region.image.copy(region.source);
+                    m_scaled_image = visible.scaled(target_size, Qt::IgnoreAspectRatio,
+                                                    m_smooth_scaling ? Qt::SmoothTransformation : Qt::FastTransformation);
+                    m_scaled_level = region.level;
+                    m_scaled_source = region.source;
+                }
+                painter.drawImage(QPoint((int) std::lround(region.target.x()), (int) std::lround(region.target.y())),
+                                  m_scaled_image);
+            }
+
+            markFramePainted();
+
+            paintOverlay(painter);
+        }
+    }
+
+    void resizeEvent(QResizeEvent *event) override {
+        QOpenGLWidget::resizeEvent(event);
+
+        // 控件可能被移到刷新率不同的屏幕
+        if (m_display_rate <= 0) m_display_timer.start(displayIntervalMsec());
+    }
+
+    void wheelEvent(QWheelEvent *event) override {
+        if (m_image.isNull()) return;
+
+        // 滚轮每 4 格缩放一倍
+        zoomAt(event->position(), getZoom() * std::pow(2.0, event->angleDelta().y() / 480.0));
+    }
 
-            // 使用 painter 进行其他绘制操作
-            // ...
+    void mousePressEvent(QMouseEvent *event) override {
+        if (event->button() != Qt::LeftButton) return;
+
+        m_dragging = true;
+        m_drag_last = event->pos();
+    }
+
+    void mouseMoveEvent(QMouseEvent *event) override {
+        if (!m_dragging) return;
+
+        QPoint delta = event->pos() - m_drag_last;
+        m_drag_last = event->pos();
+        if (m_view_scale <= 0) return;
+
+        // 拖出图像后立即夹回，否则反向拖动要先抵消越界的距离画面才会移动
+        m_view_center = clampViewCenter(m_view_center - QPointF(delta) / m_view_scale);
+        viewChanged();
+    }
+
+    void mouseReleaseEvent(QMouseEvent *event) override {
+        if (event->button() == Qt::LeftButton) m_dragging = false;
+    }
+
+    void mouseDoubleClickEvent(QMouseEvent *event) override {
+        if (event->button() != Qt::LeftButton) return;
+
+        if (m_view_scale <= 0) {
+            zoomAt(QPointF(event->pos()), 1.0);
+        } else {
+            zoomToFit();
         }
     }
 
     void slotUpdateImage(QImage image) {
-        m_image = image;
+        m_pending_frame.reset();
+        m_pending_image = image;
+        m_has_pending = true;
+        m_frames_received++;
+    }
+
+    void slotUpdateFrame(FrameRef frame) {
+        if (m_camera) m_camera->recordFramePickup(frame);
+
+        // 只保留最新一帧，被覆盖的帧立即归还帧池
+        m_pending_frame = std::move(frame);
+        m_pending_image = QImage();
+        m_has_pending = true;
+        m_frames_received++;
+    }
+
+private slots:
+    void onDisplayTick() {
+        if (!m_has_pending) return;
+        m_has_pending = false;
+
+        m_frame = std::move(m_pending_frame);
+        m_image = m_frame ? m_frame.toQImage() : m_pending_image;
+        m_pending_frame.reset();
+        m_pending_image = QImage();
+        m_scaled_image = QImage();
+        m_pyramid.clear();
+        m_texture_dirty = true;
+        m_frame_painted = false;
 
         update();
     }
 
+signals:
+    // 缩放比例或显示中心改变
+    void signalViewChanged(double zoom);
+
 private:
+    static constexpr double kMaxZoom = 32;
+    static constexpr int kMaxPyramidLevels = 8;
+
+    /**
+     * @brief 当前视图需要绘制的部分：金字塔层、该层中的可见区域及其在控件中的位置
+     */
+    struct ViewRegion {
+        bool valid = false;
+        int level = 0;
+        QImage image;        // 金字塔层图像
+        QRect source;        // 层图像中的可见区域
+        QRectF target;       // source 在控件中的位置，可能略超出控件
+    };
+
+    void viewChanged() {
+        m_scaled_image = QImage();
+        update();
+
+        emit signalViewChanged(getZoom());
+    }
+
+    double fitScale() const {
+        if (m_image.isNull() || m_image.width() <= 0 || m_image.height() <= 0) return 1;
+
+        return std::min((double) width() / m_image.width(), (double) height() / m_image.height());
+    }
+
+    ViewRegion computeViewRegion() {
+        ViewRegion region;
+        if (m_image.isNull()) return region;
+
+        QRectF image_rect = calculateImageRectF();
+        QRectF visible = image_rect.intersected(QRectF(0, 0, width(), height()));
+        if (visible.isEmpty() || image_rect.width() <= 0 || image_rect.height() <= 0) return region;
+
+        double scale_x = image_rect.width() / m_image.width();
+        double scale_y = image_rect.height() / m_image.height();
+
+        // 选取每个设备像素至少对应一个层像素的最小一层
+        double device_scale = std::max(scale_x, scale_y) * devicePixelRatioF();
+        int level = 0;
+        while (level < kMaxPyramidLevels && device_scale * (double) (2 << level) <= 1.0 &&
+               (m_image.width() >> (level + 1)) > 0 && (m_image.height() >> (level + 1)) > 0) {
+            level++;
+        }
+
+        region.image = pyramidImage(level);
+        region.level = level;
+
+        double fx = (double) region.image.width() / m_image.width();
+        double fy = (double) region.image.height() / m_image.height();
+        QRectF source((visible.x() - image_rect.x()) / scale_x * fx, (visible.y() - image_rect.y()) / scale_y * fy,
+                      visible.width() / scale_x * fx, visible.height() / scale_y * fy);
+        region.source = source.toAlignedRect().intersected(region.image.rect());
+        if (region.source.isEmpty()) return region;
+
+        region.target = QRectF(image_rect.x() + region.source.x() / fx * scale_x,
+                               image_rect.y() + region.source.y() / fy * scale_y,
+                               region.source.width() / fx * scale_x,
+                               region.source.height() / fy * scale_y);
+        region.valid = true;
+
+        return region;
+    }
+
+    /**
+     * @brief 当前帧的第 level 层金字塔图像（每层长宽减半），按需由上一层生成并缓存到下一帧
+     */
+    QImage pyramidImage(int level) {
+        if (m_pyramid.empty()) m_pyramid.push_back(m_image);
+
+        while ((int) m_pyramid.size() <= level) {
+            m_pyramid.push_back(halfSize(m_pyramid.back()));
+        }
+
+        return m_pyramid[level];
+    }
+
+    static QImage halfSize(const QImage &image) {
+        int width = std::max(1, image.width() / 2);
+        int height = std::max(1, image.height() / 2);
+
+        int cv_type;
+        switch (image.format()) {
+            case QImage::Format_Grayscale8: cv_type = CV_8UC1; break;
+            case QImage::Format_Grayscale16: cv_type = CV_16UC1; break;
+            case QImage::Format_RGB888: cv_type = CV_8UC3; break;
+            default: return image.scaled(width, height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+
+        // INTER_AREA 按 2x2 求平均，OpenCV 内部已向量化
+        QImage half(width, height, image.format());
+        cv::Mat src(image.height(), image.width(), cv_type, (void *) image.constBits(), (size_t) image.bytesPerLine());
+        cv::Mat dst(height, width, cv_type, half.bits(), (size_t) half.bytesPerLine());
+        cv::resize(src, dst, dst.size(), 0, 0, cv::INTER_AREA);
+
+        return half;
+    }
+
+    void markFramePainted() {
+        if (m_frame_painted) return;
+
+        m_frame_painted = true;
+        m_frames_painted++;
+
+        // 记录帧的显示时间
+        if (m_camera) m_camera->recordFramePaint(m_frame);
+    }
+
+    /**
+     * @brief QImage 格式对应的纹理上传参数，当前上下文不支持时返回 false
+     */
+    bool textureFormat(const QImage &image, GLenum &format, GLenum &type, int &bytes_per_pixel) const {
+        switch (image.format()) {
+            case QImage::Format_Grayscale8:
+                format = GL_LUMINANCE;
+                type = GL_UNSIGNED_BYTE;
+                bytes_per_pixel = 1;
+                return true;
+            case QImage::Format_Grayscale16:
+                // OpenGL ES 2.0 不支持 16 位灰度纹理
+                if (context() && context()->isOpenGLES()) return false;
+                format = GL_LUMINANCE;
+                type = GL_UNSIGNED_SHORT;
+                bytes_per_pixel = 2;
+                return true;
+            case QImage::Format_RGB888:
+                format = GL_RGB;
+                type = GL_UNSIGNED_BYTE;
+                bytes_per_pixel = 3;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief 以纹理方式绘制当前帧，无法上传时返回 false 由调用方退回 Painter 方式
+     *
+     * 纹理保存整幅帧，只在新帧到达时上传；缩放与平移只改变视口与纹理坐标。
+     */
+    bool paintTexture() {
+        if (!m_program) return false;
+
+        if (m_texture_dirty && !uploadTexture()) return false;
+
+        double ratio = devicePixelRatioF();
+        glDisable(GL_BLEND);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_SCISSOR_TEST);
+        glViewport(0, 0, (GLsizei) std::lround(width() * ratio), (GLsizei) std::lround(height() * ratio));
+        glClearColor(0, 0, 0, 1);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        // 只绘制图像在控件内的部分：视口为可见区域（GL 坐标原点在左下角），纹理坐标为其在图像中的比例
+        QRectF image_rect = calculateImageRectF();
+        QRectF visible = image_rect.intersected(QRectF(0, 0, width(), height()));
+        if (visible.isEmpty() || image_rect.width() <= 0 || image_rect.height() <= 0) return true;
+
+        GLfloat u0 = (GLfloat) ((visible.left() - image_rect.x()) / image_rect.width());
+        GLfloat u1 = (GLfloat) ((visible.right() - image_rect.x()) / image_rect.width());
+        GLfloat v0 = (GLfloat) ((visible.top() - image_rect.y()) / image_rect.height());
+        GLfloat v1 = (GLfloat) ((visible.bottom() - image_rect.y()) / image_rect.height());
+
+        glViewport((GLint) std::lround(visible.x() * ratio),
+                   (GLint) std::lround((height() - visible.y() - visible.height()) * ratio),
+                   (GLsizei) std::lround(visible.width() * ratio),
+                   (GLsizei) std::lround(visible.height() * ratio));
+
+        // 图像第一行在上方
+        static const GLfloat kPositions[] = {-1, -1, 1, -1, -1, 1, 1, 1};
+        const GLfloat texcoords[] = {u0, v1, u1, v1, u0, v0, u1, v0};
+
+        m_program->bind();
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+        m_program->setUniformValue(m_program->uniformLocation("u_texture"), 0);
+        m_program->enableAttributeArray(0);
+        m_program->enableAttributeArray(1);
+        m_program->setAttributeArray(0, kPositions, 2);
+        m_program->setAttributeArray(1, texcoords, 2);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        m_program->disableAttributeArray(0);
+        m_program->disableAttributeArray(1);
+        m_program->release();
+
+        return true;
+    }
+
+    /**
+     * @brief 把当前帧整幅上传到常驻纹理，尺寸或格式改变时才重新分配纹理存储
+     */
+    bool uploadTexture() {
+        GLenum format, type;
+        int bytes_per_pixel;
+        if (!textureFormat(m_image, format, type, bytes_per_pixel)) return false;
+        if (m_image.width() > m_max_texture_size || m_image.height() > m_max_texture_size) return false;
+
+        // 行间无填充或按 4 字节对齐时可直接上传，否则退回
+        int row_bytes = m_image.width() * bytes_per_pixel;
+        int alignment;
+        if (m_image.bytesPerLine() == row_bytes) {
+            alignment = 1;
+        } else if (m_image.bytesPerLine() == (row_bytes + 3) / 4 * 4) {
+            alignment = 4;
+        } else {
+            return false;
+        }
+
+        if (m_texture == 0) glGenTextures(1, &m_texture);
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
+        if (m_texture_width != m_image.width() || m_texture_height != m_image.height() ||
+            m_texture_format != format || m_texture_type != type) {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_use_mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexImage2D(GL_TEXTURE_2D, 0, (GLint) format, m_image.width(), m_image.height(), 0,
+                         format, type, m_image.constBits());
+
+            m_texture_width = m_image.width();
+            m_texture_height = m_image.height();
+            m_texture_format = format;
+            m_texture_type = type;
+        } else {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_image.width(), m_image.height(),
+                            format, type, m_image.constBits());
+        }
+
+        if (m_use_mipmaps) glGenerateMipmap(GL_TEXTURE_2D);
+        m_texture_dirty = false;
+
+        return true;
+    }
+
+    /**
+     * @brief 合成叠加层，图元未改变且映射不变时直接使用缓存图像
+     */
+    void paintOverlay(QPainter &painter) {
+        if (m_overlay.isEmpty() || m_image.isNull()) return;
+
+        painter.drawImage(QPoint(0, 0), m_overlay.render(size(), imageToWidgetTransform(), devicePixelRatioF()));
+    }
+
+    /**
+     * @brief 图像像素坐标到控件坐标的映射
+     */
+    QTransform imageToWidgetTransform() const {
+        QRectF image_rect = calculateImageRectF();
+        if (m_image.isNull() || image_rect.isEmpty()) return QTransform();
+
+        QTransform transform;
+        transform.translate(image_rect.x(), image_rect.y());
+        transform.scale((double) image_rect.width() / m_image.width(), (double) image_rect.height() / m_image.height());
+
+        return transform;
+    }
+
+    int displayIntervalMsec() const {
+        double fps = m_display_rate;
+        if (fps <= 0) {
+            QScreen *current_screen = screen();
+            fps = current_screen ? current_screen->refreshRate() : 60;
+        }
+        if (fps <= 0) fps = 60;
+
+        return std::max(1, (int) std::floor(1000.0 / fps));
+    }
+
+    /**
+     * @brief 整幅图像在控件中的位置，缩放后可能超出控件
+     */
+    QRectF calculateImageRectF() const {
+        if (m_image.isNull()) return QRectF();
+        if (m_view_scale <= 0) return QRectF(calculateImageRect());
+
+        // 帧尺寸可能在设置中心后改变，这里再限制一次
+        QPointF center = clampViewCenter(m_view_center);
+
+        return QRectF(width() / 2.0 - center.x() * m_view_scale, height() / 2.0 - center.y() * m_view_scale,
+                      m_image.width() * m_view_scale, m_image.height() * m_view_scale);
+    }
+
+    /**
+     * @brief 显示中心限制在图像范围内
+     */
+    QPointF clampViewCenter(const QPointF &center) const {
+        return QPointF(std::min(std::max(center.x(), 0.0), (double) m_image.width()),
+                       std::min(std::max(center.y(), 0.0), (double) m_image.height()));
+    }
+
+    /**
+     * @brief 适应窗口时的图像位置（保持长宽比，居中）
+     */
     QRect calculateImageRect() const {
         if (m_image.isNull()) {
             return QRect();
@@ -80,7 +795,44 @@ private:
     }
 
 private:
+    CameraController *m_camera;
+    FrameRef m_frame;               // 当前显示的帧
     QImage m_image;
+    QImage m_scaled_image;          // 可见区域缩放后的缓存
+    int m_scaled_level;
+    QRect m_scaled_source;
+    std::vector<QImage> m_pyramid;  // 当前帧的金字塔（仅 Painter 方式），第 0 层为原图，按需生成
+
+    double m_view_scale;            // 控件像素 / 图像像素，<= 0 表示适应窗口
+    QPointF m_view_center;          // 显示中心（图像坐标）
+    bool m_dragging;
+    QPoint m_drag_last;
+
+    FrameRef m_pending_frame;       // 最新收到、尚未显示的帧
+    QImage m_pending_image;
+    bool m_has_pending;
+    bool m_frame_painted;
+
+    QTimer m_display_timer;
+    bool m_smooth_scaling;
+    RenderMode m_render_mode;
+
+    bool m_gl_initialized;
+    std::unique_ptr<QOpenGLShaderProgram> m_program;
+    GLuint m_texture;               // 常驻纹理，尺寸与格式不变时只更新内容
+    int m_texture_width;
+    int m_texture_height;
+    GLenum m_texture_format;
+    GLenum m_texture_type;
+    bool m_texture_dirty;           // 当前帧尚未上传
+    bool m_use_mipmaps;             // 上下文支持 glGenerateMipmap 时以 mipmap 缩小
+    int m_max_texture_size;
+    double m_display_rate;          // <= 0 表示使用屏幕刷新率
+
+    OverlayLayer m_overlay;         // 保留模式叠加层
+
+    uint64_t m_frames_received;
+    uint64_t m_frames_painted;
 };
 
 